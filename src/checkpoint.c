@@ -0,0 +1,214 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+
+/**********************************************************************************************************************/
+
+static sc_t checkpoint_s_def = "checkpoint_s = "
+"{"
+    "aware_t _;            "
+    "u2_t rseed;           "
+    "uz_t cycles;          "
+    "period_s period;      "
+    "uz_t persons;         "
+    "uz_t slots;           "
+    "uz_t next_cycle;      "
+    "u2_t next_seed;       "
+    "bl_t found;           "
+    "uz_t cycle;           "
+    "u2_t seed;            "
+    "f3_t score;           "
+    "bcore_arr_uz_s winner;"
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( checkpoint_s, checkpoint_s_def )
+
+/// writes o to a temporary file and renames it to file (a preempted write leaves the previous checkpoint intact)
+static void checkpoint_s_write( const checkpoint_s* o, sc_t file )
+{
+    st_s* tmp_file = st_s_createf( "%s.tmp", file );
+    bcore_txt_ml_a_to_file( o, tmp_file->sc );
+    if( rename( tmp_file->sc, file ) != 0 ) ERR( "Cannot replace '%s'.", file );
+    st_s_discard( tmp_file );
+}
+
+static bl_t winner_equal( const bcore_arr_uz_s* a, const bcore_arr_uz_s* b )
+{
+    if( a->size != b->size ) return false;
+    for( uz_t i = 0; i < a->size; i++ ) if( a->data[ i ] != b->data[ i ] ) return false;
+    return true;
+}
+
+/**********************************************************************************************************************/
+
+assignment_s* checkpoint_solve( const assigner_s* assigner, const assignment_s* src, period_s period, sc_t file, bl_t resume, const solve_control_s* control, bl_t* cancelled )
+{
+    if( cancelled ) *cancelled = false;
+    if( assigner->cycles == 0 ) return assignment_s_clone( src );
+    if( assigner_s_branch_search( assigner ) ) ERR( "Checkpoints require search 'random'." );
+
+    bcore_life_s* l = bcore_life_s_create();
+    solver_s* solver = bcore_life_s_push_aware( l, solver_s_create() );
+    solver_s_setup( solver, assigner, src, period );
+    trial_s* trial = bcore_life_s_push_aware( l, trial_s_create() );
+    trial_s* best  = bcore_life_s_push_aware( l, trial_s_create() );
+
+    checkpoint_s* o = bcore_life_s_push_aware( l, checkpoint_s_create() );
+    o->rseed      = assigner->rseed;
+    o->cycles     = assigner->cycles;
+    o->period     = period;
+    o->persons    = solver->model.persons.size;
+    o->slots      = calendar_s_slots( &solver->calendar );
+    o->next_cycle = 0;
+    o->next_seed  = solver_seed( assigner->rseed, 0 );
+
+    if( resume && access( file, F_OK ) == 0 )
+    {
+        sr_s sr = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( file ) );
+        if( sr_s_type( &sr ) != TYPEOF_checkpoint_s ) ERR( "Incorrect file '%s'. <checkpoint_s> expected.", file );
+        const checkpoint_s* c = sr.o;
+        if( c->rseed != o->rseed || c->cycles != o->cycles ) ERR( "'%s': rseed or cycles differ from configuration.", file );
+        if( c->period.first.cday != period.first.cday || c->period.last.cday != period.last.cday ) ERR( "'%s': period differs.", file );
+        if( c->persons != o->persons || c->slots != o->slots ) ERR( "'%s': assignment or demand differs.", file );
+        if( c->next_cycle > c->cycles || c->next_seed != solver_seed( c->rseed, c->next_cycle ) ) ERR( "'%s': inconsistent cycle state.", file );
+        if( c->found )
+        {
+            trial_s_run( best, solver, c->seed );
+            best->cycle = c->cycle;
+            if( !winner_equal( &best->winner, &c->winner ) ) ERR( "'%s': best trial cannot be reproduced (changed inputs?).", file );
+        }
+        checkpoint_s_copy( o, c );
+    }
+
+    progress_s progress;
+    progress_s_begin( &progress, control, o->cycles );
+    f3_t time_write = guard_time_ms();
+    while( o->next_cycle < o->cycles )
+    {
+        if( solve_control_s_cancelled( control ) )
+        {
+            if( cancelled ) *cancelled = true;
+            break;
+        }
+        trial_s_run( trial, solver, o->next_seed );
+        trial->cycle = o->next_cycle;
+        if( !o->found || trial->score > best->score )
+        {
+            trial_s_copy_state( best, trial );
+            o->found = true;
+            o->cycle = best->cycle;
+            o->seed  = best->rseed;
+            o->score = best->score;
+            bcore_arr_uz_s_copy( &o->winner, &best->winner );
+        }
+        o->next_cycle++;
+        o->next_seed = bcore_xsg3_u2( o->next_seed );
+
+        if( guard_time_ms() - time_write >= CHECKPOINT_INTERVAL_MS )
+        {
+            checkpoint_s_write( o, file );
+            time_write = guard_time_ms();
+        }
+        progress_s_update( &progress, o->next_cycle, best->score, false );
+    }
+    progress_s_update( &progress, o->next_cycle, best->score, true );
+    checkpoint_s_write( o, file );
+
+    assignment_s* assignment = o->found ? solver_s_create_assignment( solver, src, best ) : assignment_s_clone( src );
+    bcore_life_s_discard( l );
+    return assignment;
+}
+
+/**********************************************************************************************************************/
+
+/// cancels a solve once cycle trials are done (selftest)
+typedef struct cancel_at_s
+{
+    bl_t cancel;
+    uz_t cycle;
+} cancel_at_s;
+
+static void cancel_at( vd_t arg, uz_t done, uz_t total, f3_t best_score, f3_t elapsed_ms )
+{
+    cancel_at_s* o = arg;
+    if( done >= o->cycle ) o->cancel = true;
+}
+
+static void checkpoint_selftest( void )
+{
+    bcore_life_s* l = bcore_life_s_create();
+
+    const assignment_s* src = bcore_life_s_push_aware( l, guard_selftest_assignment_create() );
+    period_s period = guard_selftest_period();
+    assigner_s* assigner = bcore_life_s_push_aware( l, assigner_s_create() );
+    assigner->cycles = 24;
+    st_s* temp_file = bcore_life_s_push_aware( l, guard_selftest_temp_file_create( "checkpoint" ) );
+    sc_t file = temp_file->sc;
+
+    // uninterrupted
+    const assignment_s* direct = bcore_life_s_push_aware( l, checkpoint_solve( assigner, src, period, file, false, NULL, NULL ) );
+    const checkpoint_s* c_direct = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( file ) ).o;
+    ASSERT( c_direct->found && c_direct->next_cycle == assigner->cycles );
+
+    // cancelled after some cycles, then resumed from file
+    cancel_at_s cancel = { .cycle = 7 };
+    solve_control_s control = { .cancel = &cancel.cancel, .progress = cancel_at, .progress_arg = &cancel };
+    bl_t cancelled = false;
+    assignment_s_discard( checkpoint_solve( assigner, src, period, file, false, &control, &cancelled ) );
+    ASSERT( cancelled );
+    const checkpoint_s* c_part = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( file ) ).o;
+    ASSERT( c_part->next_cycle == cancel.cycle );
+
+    const assignment_s* resumed = bcore_life_s_push_aware( l, checkpoint_solve( assigner, src, period, file, true, NULL, NULL ) );
+    const checkpoint_s* c_resumed = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( file ) ).o;
+    ASSERT( c_resumed->next_cycle == assigner->cycles );
+    ASSERT( c_resumed->cycle == c_direct->cycle && c_resumed->seed == c_direct->seed );
+    ASSERT( c_resumed->score == c_direct->score );
+    ASSERT( winner_equal( &c_resumed->winner, &c_direct->winner ) );
+    ASSERT( bcore_compare_aware( resumed, direct ) == 0 );
+
+    unlink( file );
+    bcore_life_s_discard( l );
+}
+
+/**********************************************************************************************************************/
+
+vd_t checkpoint_signal_handler( const bcore_signal_s* o )
+{
+    switch( bcore_signal_s_handle_type( o, typeof( "checkpoint" ) ) )
+    {
+        case TYPEOF_init1:
+        {
+            BCORE_REGISTER_OBJECT( checkpoint_s );
+        }
+        break;
+
+        case TYPEOF_selftest:
+        {
+            checkpoint_selftest();
+        }
+        break;
+
+        default: break;
+    }
+    return NULL;
+}
+
+/**********************************************************************************************************************/
+
@@ -0,0 +1,64 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Checkpoint and Resume
+ *  A long solve periodically saves its progress (next cycle, seed of the next cycle and the best trial so far)
+ *  to a small file (txt_ml). Resuming continues from that cycle; the result is identical to an uninterrupted run.
+ *  The best trial is stored compactly by its seed and the winner of each slot. On resume the trial is re-run
+ *  from its seed and compared with the stored winners, which detects changed inputs.
+ */
+
+/// minimum time between two checkpoints
+#define CHECKPOINT_INTERVAL_MS 30000
+
+#define TYPEOF_checkpoint_s typeof( "checkpoint_s" )
+typedef struct checkpoint_s
+{
+    aware_t _;
+    u2_t rseed;            // rseed of assigner
+    uz_t cycles;           // cycles of assigner
+    period_s period;
+    uz_t persons;
+    uz_t slots;
+    uz_t next_cycle;       // first cycle not yet run
+    u2_t next_seed;        // seed of next_cycle
+    bl_t found;            // a best trial exists
+    uz_t cycle;            // cycle of best trial
+    u2_t seed;             // seed of best trial
+    f3_t score;            // informational
+    bcore_arr_uz_s winner; // person (model index) per slot of best trial
+} checkpoint_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( checkpoint_s )
+
+/** Solves like assigner_s_create_assignment and saves a checkpoint to file at least every CHECKPOINT_INTERVAL_MS
+ *  and when finished or cancelled. resume: continues from file if it exists.
+ *  control (optional): cancellation and progress; a cancelled solve returns the best assignment so far.
+ *  cancelled (optional): receives true if the solve was cancelled.
+ */
+assignment_s* checkpoint_solve( const assigner_s* assigner, const assignment_s* src, period_s period, sc_t file, bl_t resume, const solve_control_s* control, bl_t* cancelled );
+
+/**********************************************************************************************************************/
+
+vd_t checkpoint_signal_handler( const bcore_signal_s* o );
+
+/**********************************************************************************************************************/
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,139 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include "context.h"
+#include "history.h"
+#include "loader.h"
+#include "parser.h"
+#include "template.h"
+#include "shard.h"
+#include "checkpoint.h"
+#include "export.h"
+
+/**********************************************************************************************************************/
+
+static sc_t guard_context_s_def = "guard_context_s = "
+"{"
+    "aware_t _;              "
+    "assigner_s   assigner;  "
+    "assignment_s assignment;"
+    "solver_s     solver;    "
+    "bl_t         prepared;  "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( guard_context_s, guard_context_s_def )
+
+guard_context_s* guard_context_s_create_from_files( sc_t assigner_file, sc_t assignment_path )
+{
+    guard_context_s* o = guard_context_s_create();
+
+    sr_s assigner_sr = parser_from_file( assigner_file );
+    if( sr_s_type( &assigner_sr ) != TYPEOF_assigner_s ) ERR( "Incorrect file '%s'. <assigner_s> expected.", assigner_file );
+    assigner_s_copy( &o->assigner, assigner_sr.o );
+    sr_down( assigner_sr );
+
+    assignment_s* assignment = assignment_s_create_from_path( assignment_path );
+    assignment_s_copy( &o->assignment, assignment );
+    assignment_s_discard( assignment );
+
+    return o;
+}
+
+void guard_context_s_attach( guard_context_s* o, const assigner_s* assigner, const assignment_s* assignment )
+{
+    assigner_s_copy( &o->assigner, assigner );
+    assignment_s_copy( &o->assignment, assignment );
+    o->prepared = false;
+}
+
+void guard_context_s_set_assigner( guard_context_s* o, const assigner_s* assigner )
+{
+    assigner_s_copy( &o->assigner, assigner );
+    o->prepared = false;
+}
+
+void guard_context_s_set_assignment( guard_context_s* o, const assignment_s* assignment )
+{
+    assignment_s_copy( &o->assignment, assignment );
+    if( o->prepared ) solver_s_set_assignment( &o->solver, &o->assignment );
+}
+
+void guard_context_s_prepare( guard_context_s* o, period_s period )
+{
+    if( !o->prepared )
+    {
+        solver_s_setup( &o->solver, &o->assigner, &o->assignment, period );
+        o->prepared = true;
+    }
+    else if( o->solver.calendar.period.first.cday != period.first.cday || o->solver.calendar.period.last.cday != period.last.cday )
+    {
+        solver_s_set_period( &o->solver, period );
+    }
+}
+
+assignment_s* guard_context_s_solve( guard_context_s* o, period_s period, u2_t rseed, uz_t cycles, f3_t* score )
+{
+    if( cycles == 0 )
+    {
+        if( score ) *score = 0;
+        return assignment_s_clone( &o->assignment );
+    }
+
+    guard_context_s_prepare( o, period );
+    trial_s* best = trial_s_create();
+    solver_s_solve( &o->solver, rseed, cycles, best );
+    assignment_s* result = solver_s_create_assignment( &o->solver, &o->assignment, best );
+    if( score ) *score = best->score;
+    trial_s_discard( best );
+    return result;
+}
+
+st_s* guard_context_s_render( const guard_context_s* o, const assignment_s* result, period_s period, sc_t format )
+{
+    st_s* out = assigner_s_show( &o->assigner, result, period, format );
+    return out ? out : assigner_s_export( &o->assigner, result, period, format );
+}
+
+/**********************************************************************************************************************/
+
+static vd_t context_signal_handler( const bcore_signal_s* o )
+{
+    switch( bcore_signal_s_handle_type( o, typeof( "context" ) ) )
+    {
+        case TYPEOF_init1:
+        {
+            BCORE_REGISTER_OBJECT( guard_context_s );
+        }
+        break;
+
+        default: break;
+    }
+    return NULL;
+}
+
+vd_t crossing_guard_signal_handler( const bcore_signal_s* o )
+{
+    guard_signal_handler( o );
+    history_signal_handler( o );
+    shard_signal_handler( o );
+    checkpoint_signal_handler( o );
+    parser_signal_handler( o );
+    template_signal_handler( o );
+    context_signal_handler( o );
+    return NULL;
+}
+
+/**********************************************************************************************************************/
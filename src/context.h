@@ -0,0 +1,80 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Solver Context: API for using crossing_guard as library (bin/libcrossing_guard.a, bin/libcrossing_guard.so).
+ *
+ *  A context holds assigner and assignment. Compiled model, calendar and availability are computed once and reused
+ *  for all solve and render calls; the calendar is recomputed only when the period changes.
+ *
+ *  Usage:
+ *     bcore_register_signal_handler( crossing_guard_signal_handler );
+ *     guard_context_s* context = guard_context_s_create_from_files( "config.txt", "assignment.txt" );
+ *     assignment_s* result = guard_context_s_solve( context, period, rseed, cycles, &score );
+ *     st_s* html = guard_context_s_render( context, result, period, "html_table" );
+ *     ...
+ *     guard_context_s_discard( context );
+ *     bcore_down( false );
+ *
+ *  Solving for the prepared period does not modify the context: Concurrent calls of guard_context_s_solve
+ *  are permitted after guard_context_s_prepare for that period.
+ */
+
+#define TYPEOF_guard_context_s typeof( "guard_context_s" )
+typedef struct guard_context_s
+{
+    aware_t _;
+    assigner_s   assigner;
+    assignment_s assignment;
+    solver_s     solver;
+    bl_t         prepared; // solver holds model of assignment
+} guard_context_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( guard_context_s )
+
+/// assignment_path: file, directory or glob pattern (see loader.h)
+guard_context_s* guard_context_s_create_from_files( sc_t assigner_file, sc_t assignment_path );
+
+/// copies assigner and assignment into the context
+void guard_context_s_attach( guard_context_s* o, const assigner_s* assigner, const assignment_s* assignment );
+
+/// replaces the assigner (model and calendar are recomputed on next prepare)
+void guard_context_s_set_assigner( guard_context_s* o, const assigner_s* assigner );
+
+/// replaces the assignment (model is recomputed, calendar is kept)
+void guard_context_s_set_assignment( guard_context_s* o, const assignment_s* assignment );
+
+/// precomputes model (once) and calendar (per period)
+void guard_context_s_prepare( guard_context_s* o, period_s period );
+
+/// returns best assignment over cycles trials seeded by rseed; score (optional) receives its score
+assignment_s* guard_context_s_solve( guard_context_s* o, period_s period, u2_t rseed, uz_t cycles, f3_t* score );
+
+/// renders result in format (see assigner_s_show, assigner_s_export); returns NULL for an unknown format
+st_s* guard_context_s_render( const guard_context_s* o, const assignment_s* result, period_s period, sc_t format );
+
+/**********************************************************************************************************************/
+
+/// signal handler of all crossing_guard modules
+vd_t crossing_guard_signal_handler( const bcore_signal_s* o );
+
+/**********************************************************************************************************************/
+
+#endif // CONTEXT_H
@@ -0,0 +1,362 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "export.h"
+
+/**********************************************************************************************************************/
+
+/// writes "YYYY-MM-DD" into buf (size >= DMY_SIZE); returns buf
+static sc_t iso_sc_from_cday( sd_t buf, uz_t cday )
+{
+    dmy_s dt = dmy_from_cday( cday );
+    buf[ 0 ] = '0' + ( dt.year / 1000 ) % 10;
+    buf[ 1 ] = '0' + ( dt.year / 100 ) % 10;
+    buf[ 2 ] = '0' + ( dt.year / 10 ) % 10;
+    buf[ 3 ] = '0' + dt.year % 10;
+    buf[ 4 ] = '-';
+    buf[ 5 ] = '0' + dt.month / 10;
+    buf[ 6 ] = '0' + dt.month % 10;
+    buf[ 7 ] = '-';
+    buf[ 8 ] = '0' + dt.day / 10;
+    buf[ 9 ] = '0' + dt.day % 10;
+    buf[ 10 ] = 0;
+    return buf;
+}
+
+static void push_csv_sc( st_s* o, sc_t sc )
+{
+    if( !strpbrk( sc, ",\"\n\r" ) )
+    {
+        st_s_push_sc( o, sc );
+        return;
+    }
+    st_s_push_char( o, '"' );
+    for( ; *sc; sc++ )
+    {
+        if( *sc == '"' ) st_s_push_char( o, '"' );
+        st_s_push_char( o, *sc );
+    }
+    st_s_push_char( o, '"' );
+}
+
+static void push_json_sc( st_s* o, sc_t sc )
+{
+    st_s_push_char( o, '"' );
+    for( ; *sc; sc++ )
+    {
+        u0_t c = *sc;
+        if( c == '"' || c == '\\' )
+        {
+            st_s_push_char( o, '\\' );
+            st_s_push_char( o, c );
+        }
+        else if( c < 0x20 )
+        {
+            st_s_pushf( o, "\\u%04x", c );
+        }
+        else
+        {
+            st_s_push_char( o, c );
+        }
+    }
+    st_s_push_char( o, '"' );
+}
+
+static void push_u2( st_s* o, u2_t v )
+{
+    const char* p = ( const char* )&v;
+    for( uz_t i = 0; i < sizeof( v ); i++ ) st_s_push_char( o, p[ i ] );
+}
+
+/**********************************************************************************************************************/
+
+static void export_csv( st_s* log, const assignment_s* src, period_s period )
+{
+    char buf[ DMY_SIZE ];
+    st_s_push_sc( log, "name,date\n" );
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        const person_s* p = src->data[ i ];
+        for( uz_t j = 0; j < p->assigned_dates.size; j++ )
+        {
+            uz_t cday = p->assigned_dates.data[ j ].cday;
+            if( !period_s_inside( &period, cday ) ) continue;
+            push_csv_sc( log, p->name.sc );
+            st_s_push_char( log, ',' );
+            st_s_push_sc( log, iso_sc_from_cday( buf, cday ) );
+            st_s_push_char( log, '\n' );
+        }
+    }
+}
+
+static void export_jsonl( st_s* log, const assignment_s* src, period_s period )
+{
+    char buf[ DMY_SIZE ];
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        const person_s* p = src->data[ i ];
+        st_s_push_sc( log, "{\"name\":" );
+        push_json_sc( log, p->name.sc );
+        st_s_push_sc( log, ",\"dates\":[" );
+        bl_t first = true;
+        for( uz_t j = 0; j < p->assigned_dates.size; j++ )
+        {
+            uz_t cday = p->assigned_dates.data[ j ].cday;
+            if( !period_s_inside( &period, cday ) ) continue;
+            if( !first ) st_s_push_char( log, ',' );
+            st_s_pushf( log, "\"%s\"", iso_sc_from_cday( buf, cday ) );
+            first = false;
+        }
+        st_s_push_sc( log, "]}\n" );
+    }
+}
+
+/// one row per slot of each active day (more rows if more persons are assigned than required)
+static void export_days( st_s* log, const assigner_s* o, const assignment_s* src, period_s period, bl_t json )
+{
+    char buf[ DMY_SIZE ];
+    calendar_s* calendar = calendar_s_create();
+    calendar_s_setup( calendar, o, period );
+    bcore_arr_uz_s* day_first = bcore_arr_uz_s_create();
+    bcore_arr_uz_s* day_persons = assignment_s_create_day_persons( src, period.first.cday, period.last.cday, day_first );
+
+    if( !json ) st_s_push_sc( log, "date,weekday,name\n" );
+    for( uz_t j = 0; j < calendar->cday_arr.size; j++ )
+    {
+        uz_t cday = calendar->cday_arr.data[ j ];
+        uz_t first = day_first->data[ cday - period.first.cday ];
+        uz_t end   = day_first->data[ cday - period.first.cday + 1 ];
+        uz_t demand = calendar_s_demand( calendar, j );
+        uz_t rows = ( end - first > demand ) ? end - first : demand;
+        sc_t wday = sc_from_wday( wday_from_cday( cday ) );
+        for( uz_t k = 0; k < rows; k++ )
+        {
+            sc_t name = ( first + k < end ) ? src->data[ day_persons->data[ first + k ] ]->name.sc : NULL;
+            if( json )
+            {
+                st_s_pushf( log, "{\"date\":\"%s\",\"weekday\":\"%s\",\"name\":", iso_sc_from_cday( buf, cday ), wday );
+                if( name ) push_json_sc( log, name ); else st_s_push_sc( log, "null" );
+                st_s_push_sc( log, "}\n" );
+            }
+            else
+            {
+                st_s_pushf( log, "%s,%s,", iso_sc_from_cday( buf, cday ), wday );
+                if( name ) push_csv_sc( log, name );
+                st_s_push_char( log, '\n' );
+            }
+        }
+    }
+
+    bcore_arr_uz_s_discard( day_persons );
+    bcore_arr_uz_s_discard( day_first );
+    calendar_s_discard( calendar );
+}
+
+static void export_bin( st_s* log, const assignment_s* src, period_s period )
+{
+    st_s_push_sc( log, EXPORT_MAGIC );
+    push_u2( log, src->size );
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        st_s_push_sc( log, src->data[ i ]->name.sc );
+        st_s_push_char( log, 0 );
+    }
+
+    uz_t pairs = 0;
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        const date_arr_s* a = &src->data[ i ]->assigned_dates;
+        for( uz_t j = 0; j < a->size; j++ ) pairs += period_s_inside( &period, a->data[ j ].cday );
+    }
+
+    push_u2( log, pairs );
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        const date_arr_s* a = &src->data[ i ]->assigned_dates;
+        for( uz_t j = 0; j < a->size; j++ )
+        {
+            if( !period_s_inside( &period, a->data[ j ].cday ) ) continue;
+            push_u2( log, i );
+            push_u2( log, a->data[ j ].cday );
+        }
+    }
+}
+
+/**********************************************************************************************************************/
+// delta
+
+/// assigned days of p (NULL: none) inside period in ascending order
+static void delta_dates( bcore_arr_uz_s* dates, const person_s* p, period_s period )
+{
+    bcore_arr_uz_s_clear( dates );
+    if( !p ) return;
+    for( uz_t i = 0; i < p->assigned_dates.size; i++ )
+    {
+        uz_t cday = p->assigned_dates.data[ i ].cday;
+        if( period_s_inside( &period, cday ) ) bcore_arr_uz_s_push( dates, cday );
+    }
+    bcore_arr_uz_s_sort( dates, 1 );
+}
+
+static void delta_push_dates( st_s* log, const bcore_arr_uz_s* dates, bl_t json )
+{
+    char buf[ DMY_SIZE ];
+    for( uz_t i = 0; i < dates->size; i++ )
+    {
+        if( json )
+        {
+            if( i > 0 ) st_s_push_char( log, ',' );
+            st_s_pushf( log, "\"%s\"", iso_sc_from_cday( buf, dates->data[ i ] ) );
+        }
+        else
+        {
+            if( i > 0 ) st_s_push_sc( log, ", " );
+            st_s_push_sc( log, dmy_sc_from_cday( buf, dates->data[ i ] ) );
+        }
+    }
+}
+
+/** Change set of one person: merges the ascending days of baseline and result in one pass.
+ *  Returns the number of changed days; nothing is written for an unchanged person.
+ */
+static uz_t delta_person( st_s* log, sc_t name, const bcore_arr_uz_s* old_dates, const bcore_arr_uz_s* new_dates, bcore_arr_uz_s* added, bcore_arr_uz_s* removed, bl_t json )
+{
+    bcore_arr_uz_s_clear( added );
+    bcore_arr_uz_s_clear( removed );
+    uz_t i = 0, j = 0;
+    while( i < old_dates->size || j < new_dates->size )
+    {
+        uz_t a = ( i < old_dates->size ) ? old_dates->data[ i ] : ( uz_t )-1;
+        uz_t b = ( j < new_dates->size ) ? new_dates->data[ j ] : ( uz_t )-1;
+        if( a < b ) bcore_arr_uz_s_push( removed, a );
+        if( b < a ) bcore_arr_uz_s_push( added,   b );
+        if( a <= b ) while( i < old_dates->size && old_dates->data[ i ] == a ) i++;
+        if( b <= a ) while( j < new_dates->size && new_dates->data[ j ] == b ) j++;
+    }
+
+    uz_t changes = added->size + removed->size;
+    if( changes == 0 ) return 0;
+
+    if( json )
+    {
+        st_s_push_sc( log, "{\"name\":" );
+        push_json_sc( log, name );
+        st_s_push_sc( log, ",\"added\":[" );
+        delta_push_dates( log, added, true );
+        st_s_push_sc( log, "],\"removed\":[" );
+        delta_push_dates( log, removed, true );
+        st_s_push_sc( log, "]}\n" );
+    }
+    else
+    {
+        st_s_pushf( log, "%s:", name );
+        if( added->size > 0 )
+        {
+            st_s_push_sc( log, " added " );
+            delta_push_dates( log, added, false );
+            if( removed->size > 0 ) st_s_push_char( log, ';' );
+        }
+        if( removed->size > 0 )
+        {
+            st_s_push_sc( log, " removed " );
+            delta_push_dates( log, removed, false );
+        }
+        st_s_push_char( log, '\n' );
+    }
+    return changes;
+}
+
+st_s* assignment_s_export_delta( const assignment_s* o, const assignment_s* baseline, period_s period, sc_t format )
+{
+    bl_t json = false;
+    if( bcore_strcmp( format, "delta_jsonl" ) == 0 )
+    {
+        json = true;
+    }
+    else if( bcore_strcmp( format, "delta" ) != 0 )
+    {
+        return NULL;
+    }
+
+    st_s* log = st_s_create();
+    bcore_life_s* l = bcore_life_s_create();
+    bcore_arr_uz_s* old_dates = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s* new_dates = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s* added     = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s* removed   = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+
+    if( !json ) st_s_push_sc( log, "#### Changes against baseline: ####\n\n" );
+
+    // persons are matched by name in one merge pass over both sorted lists
+    person_ref_s* old_refs = assignment_s_create_name_refs( baseline );
+    person_ref_s* new_refs = assignment_s_create_name_refs( o );
+    uz_t changes = 0;
+    uz_t persons = 0;
+    for( uz_t i = 0, j = 0; i < baseline->size || j < o->size; )
+    {
+        int c = ( i == baseline->size ) ? 1 : ( j == o->size ) ? -1 : person_name_cmp( old_refs[ i ].person->name.sc, new_refs[ j ].person->name.sc );
+        const person_s* old_person = ( c <= 0 ) ? old_refs[ i++ ].person : NULL;
+        const person_s* new_person = ( c >= 0 ) ? new_refs[ j++ ].person : NULL;
+        delta_dates( old_dates, old_person, period );
+        delta_dates( new_dates, new_person, period );
+        sc_t name = new_person ? new_person->name.sc : old_person->name.sc;
+        uz_t person_changes = delta_person( log, name, old_dates, new_dates, added, removed, json );
+        changes += person_changes;
+        persons += ( person_changes > 0 );
+    }
+
+    if( !json ) st_s_pushf( log, "\n%zu changed dates, %zu persons affected\n", changes, persons );
+
+    bcore_free( new_refs );
+    bcore_free( old_refs );
+    bcore_life_s_discard( l );
+    return log;
+}
+
+/**********************************************************************************************************************/
+
+st_s* assigner_s_export( const assigner_s* o, const assignment_s* src, period_s period, sc_t format )
+{
+    st_s* log = st_s_create();
+    if( bcore_strcmp( format, "csv" ) == 0 )
+    {
+        export_csv( log, src, period );
+    }
+    else if( bcore_strcmp( format, "csv_days" ) == 0 )
+    {
+        export_days( log, o, src, period, false );
+    }
+    else if( bcore_strcmp( format, "jsonl" ) == 0 )
+    {
+        export_jsonl( log, src, period );
+    }
+    else if( bcore_strcmp( format, "jsonl_days" ) == 0 )
+    {
+        export_days( log, o, src, period, true );
+    }
+    else if( bcore_strcmp( format, "bin" ) == 0 )
+    {
+        export_bin( log, src, period );
+    }
+    else
+    {
+        st_s_discard( log );
+        return NULL;
+    }
+    return log;
+}
+
+/**********************************************************************************************************************/
+
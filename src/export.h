@@ -0,0 +1,52 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Machine-readable export of an assignment result: names and assigned dates inside the period only.
+ *  Dates are written as YYYY-MM-DD (ISO 8601).
+ *
+ *  Formats:
+ *    csv         name,date (one row per assignment)
+ *    csv_days    date,weekday,name (one row per slot of each active day; name empty when unfilled)
+ *    jsonl       {"name":...,"dates":[...]} (one line per person)
+ *    jsonl_days  {"date":...,"weekday":...,"name":...} (one line per slot of each active day; name null when unfilled)
+ *    bin         EXPORT_MAGIC, u2_t persons, zero-terminated names, u2_t pairs, pairs of u2_t (person index, cday)
+ *                (native byte order)
+ */
+
+#define EXPORT_MAGIC "CGASGN01"
+
+/// returns NULL for an unknown format
+st_s* assigner_s_export( const assigner_s* o, const assignment_s* src, period_s period, sc_t format );
+
+/** Change set of result o against a previously published baseline (days inside the period; persons matched by name).
+ *  Only persons with changes are listed; unchanged parts are not rendered.
+ *
+ *  Formats:
+ *    delta        <name>: added DD.MM.YYYY, ...; removed DD.MM.YYYY, ... (one line per person) and a summary
+ *    delta_jsonl  {"name":...,"added":[...],"removed":[...]} (one line per person)
+ *
+ *  Returns NULL for an unknown format.
+ */
+st_s* assignment_s_export_delta( const assignment_s* o, const assignment_s* baseline, period_s period, sc_t format );
+
+/**********************************************************************************************************************/
+
+#endif // EXPORT_H
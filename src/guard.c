@@ -13,6 +13,10 @@
  *  limitations under the License.
  */
 
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "guard.h"
 
 /**********************************************************************************************************************/
@@ -43,10 +47,8 @@ dmy_s* date_from_string( const st_s* string )
 
 st_s* string_from_cday( uz_t cday )
 {
-    dmy_s* dt = dmy_s_from_cday( cday );
-    st_s* s = string_from_date( dt );
-    dmy_s_discard( dt );
-    return s;
+    char buf[ DMY_SIZE ];
+    return st_s_create_sc( dmy_sc_from_cday( buf, cday ) );
 }
 
 st_s* l_string_from_cday( bcore_life_s* l, uz_t cday )
@@ -85,17 +87,15 @@ void dmy_s_check_plausibility( const dmy_s* o )
     }
 }
 
-uz_t cday_from_dmy_s( const dmy_s* o )
+static uz_t cday_from_dmy( uz_t day, uz_t month, uz_t year )
 {
-    dmy_s_check_plausibility( o );
-
-    uz_t yr = o->year - 1900;
+    uz_t yr = year - 1900;
     uz_t leap_days = 1 + ( yr / 4 );
-    if( ( o->month < 3 ) && ( yr % 4 == 0 ) ) leap_days--;
+    if( ( month < 3 ) && ( yr % 4 == 0 ) ) leap_days--;
 
     uz_t sum = yr * 365 + leap_days;
 
-    switch( o->month - 1 )
+    switch( month - 1 )
     {
         case 11: sum += 30;
         case 10: sum += 31;
@@ -112,7 +112,7 @@ uz_t cday_from_dmy_s( const dmy_s* o )
         default: break;
     }
 
-    sum += o->day - 1;
+    sum += day - 1;
 
     if( sum < 60 ) ERR( "lowest possible cday: '0' is mapped to 01.03.1900" );
     sum -= 60;
@@ -120,14 +120,65 @@ uz_t cday_from_dmy_s( const dmy_s* o )
     return sum;
 }
 
+uz_t cday_from_dmy_s( const dmy_s* o )
+{
+    dmy_s_check_plausibility( o );
+    return cday_from_dmy( o->day, o->month, o->year );
+}
+
+bl_t cday_parse_dmy_sc( sc_t sc, uz_t* cday )
+{
+    static const uz_t max_digits[ 3 ] = { 2, 2, 4 };
+    uz_t v[ 3 ] = { 0, 0, 0 };
+    uz_t digits = 0;
+    for( uz_t i = 0; i < 3; i++ )
+    {
+        for( digits = 0; *sc >= '0' && *sc <= '9'; sc++ )
+        {
+            if( ++digits > max_digits[ i ] ) return false;
+            v[ i ] = v[ i ] * 10 + ( *sc - '0' );
+        }
+        if( digits == 0 ) return false;
+        if( i < 2 && *sc++ != '.' ) return false;
+    }
+    if( *sc != 0 || digits != 4 ) return false;
+
+    uz_t day = v[ 0 ], month = v[ 1 ], year = v[ 2 ];
+    if( year < 1900 || year >= 2100 || month < 1 || month > 12 || day < 1 ) return false;
+    if( year == 1900 && month < 3 ) return false;
+
+    static const uz_t month_days[ 12 ] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uz_t days = month_days[ month - 1 ] + ( ( month == 2 && year % 4 == 0 ) ? 1 : 0 );
+    if( day > days ) return false;
+
+    *cday = cday_from_dmy( day, month, year );
+    return true;
+}
+
 uz_t cday_from_dmy_sc( sc_t sc )
 {
-    dmy_s* dt = date_from_sc( sc );
-    uz_t cday = cday_from_dmy_s( dt );
-    dmy_s_discard( dt );
+    uz_t cday = 0;
+    if( !cday_parse_dmy_sc( sc, &cday ) ) ERR( "Invalid date '%s' (expected DD.MM.YYYY).", sc );
     return cday;
 }
 
+sc_t dmy_sc_from_cday( sd_t buf, uz_t cday )
+{
+    dmy_s dt = dmy_from_cday( cday );
+    buf[ 0 ] = '0' + dt.day / 10;
+    buf[ 1 ] = '0' + dt.day % 10;
+    buf[ 2 ] = '.';
+    buf[ 3 ] = '0' + dt.month / 10;
+    buf[ 4 ] = '0' + dt.month % 10;
+    buf[ 5 ] = '.';
+    buf[ 6 ] = '0' + ( dt.year / 1000 ) % 10;
+    buf[ 7 ] = '0' + ( dt.year / 100 ) % 10;
+    buf[ 8 ] = '0' + ( dt.year / 10 ) % 10;
+    buf[ 9 ] = '0' + dt.year % 10;
+    buf[ 10 ] = 0;
+    return buf;
+}
+
 dmy_s dmy_from_cday( uz_t cd )
 {
     uz_t lyr = cd / ( 365 * 4 + 1 );
@@ -174,10 +225,7 @@ uz_t wday_from_date( const dmy_s* dt )
 
 uz_t wday_from_dmy_sc( sc_t sc )
 {
-    dmy_s* dt = date_from_sc( sc );
-    uz_t wday = wday_from_date( dt );
-    dmy_s_discard( dt );
-    return wday;
+    return wday_from_cday( cday_from_dmy_sc( sc ) );
 }
 
 sc_t sc_from_wday( uz_t wday )
@@ -209,11 +257,39 @@ uz_t wday_from_sc( sc_t sc )
     return 0;
 }
 
+u3_t guard_hash_sc( sc_t sc )
+{
+    u3_t hash = 0xcbf29ce484222325ull;
+    for( ; *sc; sc++ ) hash = ( hash ^ ( u0_t )*sc ) * 0x100000001b3ull;
+    return hash;
+}
+
+/// wall-clock time in milliseconds
+f3_t guard_time_ms( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1E3 + ts.tv_nsec * 1E-6;
+}
+
 uz_t wcnt_from_cday( uz_t cday )
 {
     return ( cday + 3 ) / 7;
 }
 
+uz_t cday_today( void )
+{
+    time_t t = time( NULL );
+    struct tm tm;
+    localtime_r( &t, &tm );
+    dmy_s dt;
+    dmy_s_init( &dt );
+    dt.day   = tm.tm_mday;
+    dt.month = tm.tm_mon + 1;
+    dt.year  = tm.tm_year + 1900;
+    return cday_from_dmy_s( &dt );
+}
+
 uz_t wnum_from_date( const dmy_s* dt )
 {
     dmy_s dt_l;
@@ -257,18 +333,13 @@ uz_t wnum_from_date( const dmy_s* dt )
 
 uz_t wnum_from_cday( uz_t cday )
 {
-    dmy_s* dt = dmy_s_from_cday( cday );
-    uz_t wnum = wnum_from_date( dt );
-    dmy_s_discard( dt );
-    return wnum;
+    dmy_s dt = dmy_from_cday( cday );
+    return wnum_from_date( &dt );
 }
 
 uz_t wnum_from_dmy_sc( sc_t sc )
 {
-    dmy_s* dt = date_from_sc( sc );
-    uz_t wnum = wnum_from_date( dt );
-    dmy_s_discard( dt );
-    return wnum;
+    return wnum_from_cday( cday_from_dmy_sc( sc ) );
 }
 
 /**********************************************************************************************************************/
@@ -331,6 +402,20 @@ bl_t date_arr_s_matches( const date_arr_s* o, uz_t cday )
     return false;
 }
 
+void date_arr_s_reserve( date_arr_s* o, uz_t space )
+{
+    // date_s is plain: data is grown directly (compatible with the reflective teardown)
+    if( space <= o->space ) return;
+    o->data  = bcore_realloc( o->data, sizeof( date_s ) * space );
+    o->space = space;
+}
+
+void date_arr_s_push_cday( date_arr_s* o, uz_t cday )
+{
+    if( o->size == o->space ) date_arr_s_reserve( o, o->space > 0 ? o->space * 2 : 8 );
+    o->data[ o->size++ ].cday = cday;
+}
+
 /**********************************************************************************************************************/
 
 static sc_t period_s_def = "period_s = "
@@ -368,6 +453,27 @@ bl_t period_arr_s_inside( const period_arr_s* o, uz_t cday )
 
 /**********************************************************************************************************************/
 
+static sc_t demand_s_def = "demand_s = "
+"{"
+    "aware_t _;      "
+    "period_s period;"
+    "uz_t count = 1; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( demand_s, demand_s_def )
+
+/**********************************************************************************************************************/
+
+static sc_t demand_arr_s_def = "demand_arr_s = "
+"{"
+    "aware_t _;      "
+    "demand_s [] arr;"
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( demand_arr_s, demand_arr_s_def )
+
+/**********************************************************************************************************************/
+
 static sc_t weekday_availability_s_def = "weekday_availability_s = "
 "{"
     "aware_t _;                      "
@@ -437,16 +543,6 @@ static sr_s weekday_availability_s_get_weekdays( vc_t obj )
     return sr_asd( s );
 }
 
-static bl_t weekday_availability_s_match( const weekday_availability_s* o, uz_t cday, uz_t wnum )
-{
-    uz_t wday = wday_from_cday( cday );
-    if( ( o->weekday_flags & ( 1 << wday ) ) == 0 ) return false;
-    if( o->weekly_period <= 1 ) return true;
-    uz_t wdiff = wnum > o->including_week ? wnum - o->including_week : o->including_week - wnum;
-    if( wdiff % o->weekly_period == 0 ) return true;
-    return false;
-}
-
 /**********************************************************************************************************************/
 
 static sc_t preferences_s_def = "preferences_s = "
@@ -462,15 +558,6 @@ static sc_t preferences_s_def = "preferences_s = "
 
 BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( preferences_s, preferences_s_def )
 
-static f3_t preferences_s_match( const preferences_s* o, uz_t cday, uz_t wnum )
-{
-    if( date_arr_s_matches( &o->excluded_dates, cday      ) ) return 0;
-    if( period_arr_s_inside( &o->excluded_periods, cday   ) ) return 0;
-    if( weekday_availability_s_match( &o->weekday_availability, cday, wnum ) ) return o->weight;
-    if( date_arr_s_matches( &o->included_dates, cday      ) ) return o->weight;
-    return 0;
-}
-
 /**********************************************************************************************************************/
 
 static sc_t person_s_def = "person_s = "
@@ -518,60 +605,235 @@ static sr_s person_s_get_assigned_weekday( vc_t obj )
     return sr_asd( wd_st );
 }
 
-static f3_t person_s_match( const person_s* o, uz_t cday, uz_t wnum )
-{
-    uz_t wday = wday_from_cday( cday );
-    if( o->assigned_nweekday < 7 && o->assigned_nweekday != wday ) return 0;
+/**********************************************************************************************************************/
+
+static sc_t assignment_s_def = "assignment_s = "
+"{"
+    "aware_t _;       "
+    "person_s => [] arr; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( assignment_s, assignment_s_def )
 
-    f3_t weight = preferences_s_match( &o->preferences, cday, wnum );
-    f3_t max_score = 1.0;
-    f3_t score = max_score * 0.1;
-    uz_t last_assigned_cday = 0;
+void assignment_s_reserve( assignment_s* o, uz_t space )
+{
+    // links are moved in by the caller
+    if( space <= o->space ) return;
+    o->data  = bcore_realloc( o->data, sizeof( person_s* ) * space );
+    o->space = space;
+}
 
-    if( o->assigned_dates.size > 0 )
+bcore_arr_uz_s* assignment_s_create_day_persons( const assignment_s* o, uz_t first_cday, uz_t last_cday, bcore_arr_uz_s* day_first )
+{
+    bcore_arr_uz_s* persons = bcore_arr_uz_s_create();
+    bcore_arr_uz_s_clear( day_first );
+    uz_t cdays = ( last_cday >= first_cday ) ? last_cday - first_cday + 1 : 0;
+    bcore_arr_uz_s_fill( day_first, cdays + 1, 0 );
+    if( cdays == 0 ) return persons;
+
+    // last[ d ]: last person counted on day d (skips duplicate dates of a person)
+    bcore_arr_uz_s* last = bcore_arr_uz_s_create();
+    bcore_arr_uz_s_fill( last, cdays, o->size );
+    for( uz_t i = 0; i < o->size; i++ )
     {
-        for( uz_t i = 0; i < o->assigned_dates.size; i++ )
+        const date_arr_s* a = &o->data[ i ]->assigned_dates;
+        for( uz_t j = 0; j < a->size; j++ )
         {
-            uz_t assigned_cday = o->assigned_dates.data[ i ].cday;
-
-            // if person is assigned on this day return maximum score
-            if( assigned_cday == cday ) return max_score;
+            uz_t cday = a->data[ j ].cday;
+            if( cday < first_cday || cday > last_cday || last->data[ cday - first_cday ] == i ) continue;
+            last->data[ cday - first_cday ] = i;
+            day_first->data[ cday - first_cday + 1 ]++;
+        }
+    }
+    for( uz_t d = 0; d < cdays; d++ ) day_first->data[ d + 1 ] += day_first->data[ d ];
 
-            // last assigned day in the past
-            last_assigned_cday = ( cday > assigned_cday && assigned_cday > last_assigned_cday ) ? assigned_cday : last_assigned_cday;
+    bcore_arr_uz_s_fill( persons, day_first->data[ cdays ], 0 );
+    bcore_arr_uz_s* fill = bcore_arr_uz_s_create();
+    bcore_arr_uz_s_copy( fill, day_first );
+    bcore_arr_uz_s_fill( last, cdays, o->size );
+    for( uz_t i = 0; i < o->size; i++ )
+    {
+        const date_arr_s* a = &o->data[ i ]->assigned_dates;
+        for( uz_t j = 0; j < a->size; j++ )
+        {
+            uz_t cday = a->data[ j ].cday;
+            if( cday < first_cday || cday > last_cday || last->data[ cday - first_cday ] == i ) continue;
+            last->data[ cday - first_cday ] = i;
+            persons->data[ fill->data[ cday - first_cday ]++ ] = i;
         }
     }
 
-    // diff: distance from last assignment in cdays
-    f3_t diff = ( f3_t )( ( cday > last_assigned_cday ) ? ( cday - last_assigned_cday ) : 0 );
-    diff *= weight;
-    f3_t sqr_diff = diff * diff;
-    return score * sqr_diff / ( sqr_diff + 1 );
+    bcore_arr_uz_s_discard( fill );
+    bcore_arr_uz_s_discard( last );
+    return persons;
 }
 
 /**********************************************************************************************************************/
 
-static sc_t assignment_s_def = "assignment_s = "
+static sc_t model_person_s_def = "model_person_s = "
 "{"
-    "aware_t _;       "
-    "person_s => [] arr; "
+    "f3_t weight;              "
+    "u2_t name;                "
+    "u2_t dates;               "
+    "u2_t included_size;       "
+    "u2_t excluded_size;       "
+    "u2_t assigned_size;       "
+    "u2_t periods;             "
+    "u2_t periods_size;        "
+    "u2_t weekly_period;       "
+    "u2_t including_week;      "
+    "u0_t weekday_flags;       "
+    "u0_t assigned_nweekday;   "
+    "bl_t always_same_workday; "
 "}";
 
-BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( assignment_s, assignment_s_def )
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( model_person_s, model_person_s_def )
+
+static sc_t model_person_arr_s_def = "model_person_arr_s = "
+"{"
+    "aware_t _;             "
+    "model_person_s [] arr; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( model_person_arr_s, model_person_arr_s_def )
+
+static sc_t model_s_def = "model_s = "
+"{"
+    "aware_t _;                  "
+    "st_s names;                 "
+    "bcore_arr_uz_s date_pool;   "
+    "bcore_arr_uz_s period_pool; "
+    "model_person_arr_s persons; "
+"}";
 
-static uz_t assignment_s_get_assignment_index( const assignment_s* o, uz_t cday )
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( model_s, model_s_def )
+
+static int cmp_uz( const void* a, const void* b )
 {
-    for( uz_t i = 0; i < o->size; i++ )
+    uz_t va = *( const uz_t* )a;
+    uz_t vb = *( const uz_t* )b;
+    return ( va > vb ) - ( va < vb );
+}
+
+/// returns offset of name in names; table: open addressing hash table holding offset + 1 (0: empty)
+static uz_t model_s_intern_name( model_s* o, bcore_arr_uz_s* table, sc_t name )
+{
+    uz_t mask = table->size - 1;
+    for( uz_t idx = guard_hash_sc( name ) & mask; ; idx = ( idx + 1 ) & mask )
+    {
+        if( table->data[ idx ] == 0 )
+        {
+            uz_t offset = o->names.size;
+            st_s_push_sc( &o->names, name );
+            st_s_push_char( &o->names, 0 );
+            table->data[ idx ] = offset + 1;
+            return offset;
+        }
+
+        uz_t offset = table->data[ idx ] - 1;
+        if( bcore_strcmp( o->names.sc + offset, name ) == 0 ) return offset;
+    }
+}
+
+void model_s_setup( model_s* o, const assignment_s* src )
+{
+    st_s_clear( &o->names );
+    bcore_arr_uz_s_clear( &o->date_pool );
+    bcore_arr_uz_s_clear( &o->period_pool );
+    bcore_array_a_set_size( ( bcore_array* )&o->persons, src->size );
+
+    uz_t table_size = 16;
+    while( table_size < src->size * 2 ) table_size *= 2;
+    bcore_arr_uz_s* table = bcore_arr_uz_s_create();
+    bcore_arr_uz_s_fill( table, table_size, 0 );
+
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        const person_s* p = src->data[ i ];
+        const preferences_s* pref = &p->preferences;
+        model_person_s* m = &o->persons.data[ i ];
+
+        m->weight = pref->weight;
+        m->name   = model_s_intern_name( o, table, p->name.sc );
+
+        m->dates         = o->date_pool.size;
+        m->included_size = pref->included_dates.size;
+        m->excluded_size = pref->excluded_dates.size;
+        m->assigned_size = p->assigned_dates.size;
+        for( uz_t j = 0; j < pref->included_dates.size; j++ ) bcore_arr_uz_s_push( &o->date_pool, pref->included_dates.data[ j ].cday );
+        for( uz_t j = 0; j < pref->excluded_dates.size; j++ ) bcore_arr_uz_s_push( &o->date_pool, pref->excluded_dates.data[ j ].cday );
+        for( uz_t j = 0; j < p->assigned_dates.size;    j++ ) bcore_arr_uz_s_push( &o->date_pool, p->assigned_dates.data[ j ].cday );
+        qsort( o->date_pool.data + o->date_pool.size - m->assigned_size, m->assigned_size, sizeof( uz_t ), cmp_uz );
+
+        m->periods      = o->period_pool.size / 2;
+        m->periods_size = pref->excluded_periods.size;
+        for( uz_t j = 0; j < pref->excluded_periods.size; j++ )
+        {
+            bcore_arr_uz_s_push( &o->period_pool, pref->excluded_periods.data[ j ].first.cday );
+            bcore_arr_uz_s_push( &o->period_pool, pref->excluded_periods.data[ j ].last.cday );
+        }
+
+        m->weekly_period       = pref->weekday_availability.weekly_period;
+        m->including_week      = pref->weekday_availability.including_week;
+        m->weekday_flags       = pref->weekday_availability.weekday_flags;
+        m->assigned_nweekday   = p->assigned_nweekday;
+        m->always_same_workday = pref->always_same_workday;
+    }
+
+    if( o->names.size > 0xFFFFFFFFu || o->date_pool.size > 0xFFFFFFFFu || o->period_pool.size > 0xFFFFFFFFu )
+    {
+        ERR( "Assignment is too large for a compiled model." );
+    }
+
+    bcore_arr_uz_s_discard( table );
+}
+
+/// preference weight of person on cday (0: not available); exclusions supersede inclusions
+f3_t model_s_preferences_match( const model_s* o, uz_t person, uz_t cday, uz_t wnum )
+{
+    const model_person_s* p = &o->persons.data[ person ];
+    const uz_t* included = o->date_pool.data + p->dates;
+    const uz_t* excluded = included + p->included_size;
+    const uz_t* periods  = o->period_pool.data + p->periods * 2;
+
+    for( uz_t i = 0; i < p->excluded_size; i++ ) if( excluded[ i ] == cday ) return 0;
+    for( uz_t i = 0; i < p->periods_size; i++ ) if( cday >= periods[ i * 2 ] && cday <= periods[ i * 2 + 1 ] ) return 0;
+
+    if( p->weekday_flags & ( 1 << wday_from_cday( cday ) ) )
     {
-        person_s* p = o->data[ i ];
-        date_arr_s* a = &p->assigned_dates;
-        for( uz_t j = 0 ;j < a->size; j++ ) if( a->data[ j ].cday == cday ) return i;
+        if( p->weekly_period <= 1 ) return p->weight;
+        uz_t wdiff = wnum > p->including_week ? wnum - p->including_week : p->including_week - wnum;
+        if( wdiff % p->weekly_period == 0 ) return p->weight;
     }
-    return o->size;
+
+    for( uz_t i = 0; i < p->included_size; i++ ) if( included[ i ] == cday ) return p->weight;
+    return 0;
 }
 
 /**********************************************************************************************************************/
 
+static sc_t plan_s_def = "plan_s = "
+"{"
+    "aware_t _;                 "
+    "f3_t score;                "
+    "uz_t cycle;                "
+    "assignment_s => assignment;"
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( plan_s, plan_s_def )
+
+/**********************************************************************************************************************/
+
+static sc_t plan_arr_s_def = "plan_arr_s = "
+"{"
+    "aware_t _;     "
+    "plan_s [] arr; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( plan_arr_s, plan_arr_s_def )
+
+/**********************************************************************************************************************/
+
 static sc_t assigner_s_def = "assigner_s = "
 "{"
     "aware_t _; "
@@ -586,6 +848,16 @@ static sc_t assigner_s_def = "assigner_s = "
     "date_arr_s holidays;"
     "u2_t rseed = 12345; "
     "uz_t cycles = 128;  "
+    "st_s score_function;        " // quadratic (default), linear, capped, quota
+    "f3_t score_scale  = 0.001;  " // linear
+    "f3_t score_cap    = 28.0;   " // capped (weighted days)
+    "f3_t quota_weight = 0.01;   " // quota
+    "bl_t pin_weekdays = false;  " // fixes weekdays of always_same_workday persons before solving
+    "uz_t demand = 1;            " // persons per active day
+    "bcore_arr_uz_s weekday_demand;" // persons per weekday (mo, tu, ...)
+    "demand_arr_s demand_arr;    " // persons on specific dates
+    "st_s search;                " // random (default), branch
+    "bl_t collapse_classes = false;" // solves interchangeable persons as classes
 "}";
 
 BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( assigner_s, assigner_s_def )
@@ -598,178 +870,1912 @@ static s2_t assigner_s_free_day( const assigner_s* o, uz_t cday )
     return 0;
 }
 
-static assignment_s* assigner_s_try_assignment( const assigner_s* o, const assignment_s* src, period_s period, u2_t rseed, f3_t* score )
+bl_t assigner_s_branch_search( const assigner_s* o )
 {
-    f3_t score_l = 0;
-    uz_t count = 0;
-    uz_t fail_count = 0;
-
-    assignment_s* assignment = assignment_s_clone( src );
+    sc_t search = o->search.sc ? o->search.sc : "";
+    if( search[ 0 ] == 0 || bcore_strcmp( search, "random" ) == 0 ) return false;
+    if( bcore_strcmp( search, "branch" ) == 0 ) return true;
+    ERR( "Unknown search '%s'. Valid are random, branch.", search );
+    return false;
+}
 
+uz_t assigner_s_demand( const assigner_s* o, uz_t cday )
+{
+    uz_t demand = o->demand;
+    uz_t wday = wday_from_cday( cday );
+    if( wday < o->weekday_demand.size ) demand = o->weekday_demand.data[ wday ];
+    for( uz_t i = 0; i < o->demand_arr.size; i++ )
     {
-        bcore_arr_uz_s* permutation = bcore_arr_uz_s_create_random_permutation( bcore_xsg_u2, rseed, assignment->size );
-        bcore_array_a_reorder( (bcore_array*)assignment, permutation );
-        bcore_arr_uz_s_discard( permutation );
+        if( period_s_inside( &o->demand_arr.data[ i ].period, cday ) ) demand = o->demand_arr.data[ i ].count;
     }
+    return demand;
+}
+
+/**********************************************************************************************************************/
+
+static sc_t calendar_s_def = "calendar_s = "
+"{"
+    "aware_t _;               "
+    "period_s period;         "
+    "bcore_arr_uz_s cday_arr; "
+    "bcore_arr_uz_s wnum_arr; "
+    "bcore_arr_uz_s slot_first_arr; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( calendar_s, calendar_s_def )
 
+void calendar_s_setup( calendar_s* o, const assigner_s* assigner, period_s period )
+{
+    o->period = period;
+    bcore_arr_uz_s_clear( &o->cday_arr );
+    bcore_arr_uz_s_clear( &o->wnum_arr );
+    bcore_arr_uz_s_clear( &o->slot_first_arr );
+    uz_t slots = 0;
     for( uz_t cday = period.first.cday; cday <= period.last.cday; cday++ )
     {
-        if( assigner_s_free_day( o, cday ) ) continue;
+        if( !( &assigner->mo )[ wday_from_cday( cday ) ] ) continue;
+        if( assigner_s_free_day( assigner, cday ) ) continue;
+        uz_t demand = assigner_s_demand( assigner, cday );
+        if( demand == 0 )
+        {
+            char buf[ DMY_SIZE ];
+            ERR( "Demand on active day %s is zero (use weekday flags, vacation or holidays to exclude days).", dmy_sc_from_cday( buf, cday ) );
+        }
+        bcore_arr_uz_s_push( &o->cday_arr, cday );
+        bcore_arr_uz_s_push( &o->wnum_arr, wnum_from_cday( cday ) );
+        bcore_arr_uz_s_push( &o->slot_first_arr, slots );
+        slots += demand;
+    }
+    bcore_arr_uz_s_push( &o->slot_first_arr, slots );
+}
 
-        uz_t wday = wday_from_cday( cday );
-        uz_t wnum = wnum_from_cday( cday );
+/**********************************************************************************************************************/
 
-        if( !( &o->mo )[ wday ] ) continue;
-        f3_t best_match = 0;
-        uz_t best_idx = -1;
-        for( uz_t i = 0; i < assignment->size; i++ )
+static sc_t availability_s_def = "availability_s = "
+"{"
+    "aware_t _;                  "
+    "uz_t persons;               "
+    "uz_t days;                  "
+    "uz_t words;                 "
+    "bcore_arr_uz_s bits;        "
+    "bcore_arr_uz_s candidates;  "
+    "bcore_arr_uz_s day_first;   "
+    "bcore_arr_uz_s day_persons; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( availability_s, availability_s_def )
+
+/** A person is eligible on an active day when the solver's match can be nonzero there:
+ *  the weekday is not excluded by a fixed weekday and preferences permit the day or the day is already assigned.
+ *  Fixing weekdays during a trial only removes eligibility, hence days without eligible person are provably unfillable.
+ */
+void availability_s_setup( availability_s* o, const calendar_s* calendar, const model_s* model )
+{
+    o->persons = model->persons.size;
+    o->days    = calendar->cday_arr.size;
+    o->words   = ( o->days + GUARD_WORD_BITS - 1 ) / GUARD_WORD_BITS;
+    bcore_arr_uz_s_clear( &o->bits );
+    bcore_arr_uz_s_clear( &o->candidates );
+    bcore_arr_uz_s_fill( &o->bits, o->persons * o->words, 0 );
+    bcore_arr_uz_s_fill( &o->candidates, o->days, 0 );
+
+    for( uz_t i = 0; i < o->persons; i++ )
+    {
+        const model_person_s* p = &model->persons.data[ i ];
+        const uz_t* assigned = model_s_assigned( model, i );
+        uz_t cursor = 0;
+        uz_t* row = o->bits.data + i * o->words;
+        for( uz_t j = 0; j < o->days; j++ )
         {
-            person_s* p = assignment->data[ i ];
-            f3_t match = person_s_match( p, cday, wnum );
-            if( match > best_match )
+            uz_t cday = calendar->cday_arr.data[ j ];
+            while( cursor < p->assigned_size && assigned[ cursor ] < cday ) cursor++;
+            if( p->assigned_nweekday < 7 && p->assigned_nweekday != wday_from_cday( cday ) ) continue;
+            bl_t already_assigned = ( cursor < p->assigned_size && assigned[ cursor ] == cday );
+            if( already_assigned || model_s_preferences_match( model, i, cday, calendar->wnum_arr.data[ j ] ) != 0 )
             {
-                best_match = match;
-                best_idx = i;
+                row[ j / GUARD_WORD_BITS ] |= ( uz_t )1 << ( j % GUARD_WORD_BITS );
+                o->candidates.data[ j ]++;
             }
         }
-        if( best_idx < assignment->size )
-        {
-            person_s* p = assignment->data[ best_idx ];
+    }
 
-            bl_t already_assigned = false;
-            for( uz_t i = 0; i < p->assigned_dates.size; i++ ) already_assigned = already_assigned || ( p->assigned_dates.data[ i ].cday == cday );
-            if( !already_assigned ) bcore_array_a_push( (bcore_array*)&p->assigned_dates, sr_uz( cday ) );
-            if( p->assigned_nweekday >= 7 && p->preferences.always_same_workday ) p->assigned_nweekday = wday;
-            score_l += best_match;
-        }
-        else
+    // transposed candidate lists
+    bcore_arr_uz_s_clear( &o->day_first );
+    bcore_arr_uz_s_set_space( &o->day_first, o->days + 1 );
+    uz_t sum = 0;
+    for( uz_t j = 0; j < o->days; j++ )
+    {
+        bcore_arr_uz_s_push( &o->day_first, sum );
+        sum += o->candidates.data[ j ];
+    }
+    bcore_arr_uz_s_push( &o->day_first, sum );
+
+    bcore_arr_uz_s_clear( &o->day_persons );
+    bcore_arr_uz_s_fill( &o->day_persons, sum, 0 );
+    bcore_arr_uz_s* fill = bcore_arr_uz_s_clone( &o->day_first );
+    for( uz_t i = 0; i < o->persons; i++ )
+    {
+        const uz_t* row = o->bits.data + i * o->words;
+        for( uz_t k = 0; k < o->words; k++ )
         {
-            fail_count++;
+            for( uz_t word = row[ k ]; word; word &= word - 1 )
+            {
+                uz_t j = k * GUARD_WORD_BITS + __builtin_ctzll( word );
+                o->day_persons.data[ fill->data[ j ]++ ] = i;
+            }
         }
-        count++;
     }
+    bcore_arr_uz_s_discard( fill );
+}
 
-    score_l = ( count > 0 ) ? ( score_l / count ) - fail_count : 0;
-    if( score ) *score = score_l;
-    return assignment;
+/**********************************************************************************************************************/
+// weekday pinning
+
+/** Pinned persons of weekday u by the cost of moving them to weekday v (min-heap).
+ *  Entries of persons moved away from u are stale; they are dropped when found at the root.
+ */
+typedef struct transfer_heap_s
+{
+    f3_t* key;
+    uz_t* row;
+    uz_t  size;
+    uz_t  space;
+} transfer_heap_s;
+
+static void transfer_heap_s_down( transfer_heap_s* o )
+{
+    if( o->key ) bcore_free( o->key );
+    if( o->row ) bcore_free( o->row );
 }
 
-assignment_s* assigner_s_create_assignment( const assigner_s* o, const assignment_s* src, period_s period )
+static void transfer_heap_s_swap( transfer_heap_s* o, uz_t i, uz_t j )
 {
-    assignment_s* best_assignment = assignment_s_clone( src );
-    f3_t best_score = -1E20;
-    u2_t rval = bcore_xsg3_u2( o->rseed );
-    for( uz_t i = 0; i < o->cycles; i++ )
+    f3_t k = o->key[ i ];
+    o->key[ i ] = o->key[ j ];
+    o->key[ j ] = k;
+    uz_t r = o->row[ i ];
+    o->row[ i ] = o->row[ j ];
+    o->row[ j ] = r;
+}
+
+static void transfer_heap_s_push( transfer_heap_s* o, f3_t key, uz_t row )
+{
+    if( o->size == o->space )
     {
-        f3_t score = 0;
-        rval = bcore_xsg3_u2( rval );
-        assignment_s* try_assignment = assigner_s_try_assignment( o, src, period, rval, &score );
-        if( score > best_score )
-        {
-            best_score = score;
-            assignment_s_discard( best_assignment );
-            best_assignment = try_assignment;
-        }
-        else
-        {
-            assignment_s_discard( try_assignment );
-        }
+        o->space = ( o->space > 0 ) ? o->space * 2 : 16;
+        o->key = bcore_realloc( o->key, sizeof( f3_t ) * o->space );
+        o->row = bcore_realloc( o->row, sizeof( uz_t ) * o->space );
     }
-    return best_assignment;
+    uz_t i = o->size++;
+    o->key[ i ] = key;
+    o->row[ i ] = row;
+    for( ; i > 0 && o->key[ ( i - 1 ) / 2 ] > o->key[ i ]; i = ( i - 1 ) / 2 ) transfer_heap_s_swap( o, i, ( i - 1 ) / 2 );
 }
 
-st_s* assigner_s_show_days( const assigner_s* o, const assignment_s* src, period_s period )
+static void transfer_heap_s_pop( transfer_heap_s* o )
 {
-    st_s* log = st_s_create();
-    st_s* st_first = string_from_cday( period.first.cday );
-    st_s* st_last  = string_from_cday( period.last.cday );
-    st_s_pushf( log, "Period %s - %s\n", st_first->sc, st_last->sc );
-    st_s_discard( st_first );
-    st_s_discard( st_last );
-
-    for( uz_t cday = period.first.cday; cday <= period.last.cday; cday++ )
+    if( --o->size == 0 ) return;
+    o->key[ 0 ] = o->key[ o->size ];
+    o->row[ 0 ] = o->row[ o->size ];
+    for( uz_t i = 0;; )
     {
-        uz_t wday = wday_from_cday( cday );
-        if( wday == 0 ) st_s_pushf( log, "\n" );
-        if( !( &o->mo )[ wday ] ) continue;
-        st_s* dmy_string = string_from_cday( cday );
-        st_s_pushf( log, "    (W%02zu) %s %s: ", wnum_from_cday( cday ), sc_from_wday( wday ), dmy_string->sc );
-        st_s_discard( dmy_string );
-        uz_t idx = assignment_s_get_assignment_index( src, cday );
-        if( idx < src->size )
-        {
-            person_s* p = src->data[ idx ];
-            st_s_pushf( log, "%s\n", p->name.sc );
-        }
-        else
-        {
-            switch( assigner_s_free_day( o, cday ) )
-            {
-                case 0: st_s_pushf( log, "#### FAILURE ####\n" ); break;
-                case 1: st_s_pushf( log, "VACATION\n" ); break;
-                case 2: st_s_pushf( log, "HOLIDAY\n" ); break;
-                default: break;
-            }
-        }
+        uz_t min = i;
+        uz_t l = 2 * i + 1;
+        uz_t r = l + 1;
+        if( l < o->size && o->key[ l ] < o->key[ min ] ) min = l;
+        if( r < o->size && o->key[ r ] < o->key[ min ] ) min = r;
+        if( min == i ) return;
+        transfer_heap_s_swap( o, i, min );
+        i = min;
     }
-    return log;
 }
 
-st_s* assigner_s_show_persons( const assigner_s* o, const assignment_s* src )
+/// enters pinned person r at weekday u into the heaps of moves away from u (pref: see pin_weekdays)
+static void transfer_heaps_push( transfer_heap_s* heap, const f3_t* pref, uz_t r, uz_t u )
 {
-    st_s* log = st_s_create();
-    assignment_s* assignment = assignment_s_clone( src );
-    bcore_array_a_sort( (bcore_array*)assignment, 0, -1, 1 );
-
-    for( uz_t i = 0; i < assignment->size; i++ )
+    for( uz_t v = 0; v < 7; v++ )
     {
-        const person_s* person = assignment->data[ i ];
-        st_s_pushf( log, "%s", person->name.sc );
-        if( person->assigned_nweekday < 7 )
-        {
-            st_s_pushf( log, " (%s)", sc_from_wday( person->assigned_nweekday ) );
-        }
-        st_s_pushf( log, ":", person->name.sc );
-        for( uz_t j = 0; j < person->assigned_dates.size; j++ )
-        {
-            if( j > 0 ) st_s_pushf( log, ", " );
-            if( j % 4 == 0 ) st_s_pushf( log, "\n    " );
-            uz_t cday = person->assigned_dates.data[ j ].cday;
-            st_s_push_st_d( log, string_from_cday( cday ) );
-        }
-        st_s_pushf( log, "\n\n" );
+        if( v != u && pref[ r * 7 + v ] < INFINITY ) transfer_heap_s_push( &heap[ u * 7 + v ], pref[ r * 7 + v ] - pref[ r * 7 + u ], r );
     }
-    assignment_s_discard( assignment );
-    return log;
 }
 
-st_s* assigner_s_show_calendar( const assigner_s* o, const assignment_s* src, period_s period )
+/** Assigns a weekday to each person with always_same_workday and no fixed weekday yet (nweekday: 7 for others).
+ *  Persons are matched to weekday slots: The k-th slot of weekday w costs k / (persons required on w) (balance);
+ *  a person gains the fraction of active days on w for which it is available (preference).
+ *  Persons without availability on any active weekday stay unpinned.
+ *  The matching is a min-cost flow from persons over the 7 weekdays with convex slot costs, solved by adding one person
+ *  at a time along a shortest path: the person takes weekday w0, a person of w0 moves to w1, ..., the last weekday opens a slot.
+ *  The cheapest move between two weekdays is the root of a heap, so that paths are found among 7 nodes (Bellman-Ford).
+ */
+static void pin_weekdays( bcore_arr_uz_s* nweekday, const calendar_s* calendar, const model_s* model, const availability_s* availability )
 {
-    st_s* log = st_s_create();
-    assignment_s* assignment = assignment_s_clone( src );
+    uz_t persons = model->persons.size;
+    bcore_arr_uz_s_fill( nweekday, persons, 7 );
+    for( uz_t i = 0; i < persons; i++ ) nweekday->data[ i ] = model->persons.data[ i ].assigned_nweekday;
 
-   uz_t name_space = 0;
+    uz_t days_w[ 7 ] = { 0 };
+    for( uz_t j = 0; j < calendar->cday_arr.size; j++ ) days_w[ wday_from_cday( calendar->cday_arr.data[ j ] ) ] += calendar_s_demand( calendar, j );
 
-    sc_t week_sc = "MTWTFSS";
+    bcore_arr_uz_s* pinned = bcore_arr_uz_s_create();
+    for( uz_t i = 0; i < persons; i++ )
+    {
+        const model_person_s* p = &model->persons.data[ i ];
+        if( p->always_same_workday && p->assigned_nweekday >= 7 ) bcore_arr_uz_s_push( pinned, i );
+    }
 
-    for( uz_t i = 0; i < assignment->size; i++ )
+    uz_t rows = pinned->size;
+    if( rows == 0 )
     {
-        const person_s* person = assignment->data[ i ];
-        name_space = ( person->name.size > name_space ) ? person->name.size : name_space;
+        bcore_arr_uz_s_discard( pinned );
+        return;
     }
 
-    bcore_life_s* l = bcore_life_s_create();
-    st_s* st_first = string_from_cday( period.first.cday );
-    st_s* st_last  = string_from_cday( period.last.cday );
-    st_s_push_fa( log, "Period: #sc_t - #sc_t\n", st_first->sc, st_last->sc );
-    st_s_discard( st_first );
-    st_s_discard( st_last );
+    // pref[ r * 7 + w ]: -(active days on w for which pinned person r is available) / days_w; INFINITY: not available on w
+    f3_t* pref = bcore_malloc( sizeof( f3_t ) * rows * 7 );
+    for( uz_t r = 0; r < rows; r++ )
+    {
+        uz_t available[ 7 ] = { 0 };
+        for( uz_t j = 0; j < availability->days; j++ )
+        {
+            if( availability_s_get( availability, pinned->data[ r ], j ) ) available[ wday_from_cday( calendar->cday_arr.data[ j ] ) ]++;
+        }
+        for( uz_t w = 0; w < 7; w++ )
+        {
+            pref[ r * 7 + w ] = ( days_w[ w ] > 0 && available[ w ] > 0 ) ? -( f3_t )available[ w ] / days_w[ w ] : INFINITY;
+        }
+    }
 
-    uz_t cdays     = ( period.last.cday - period.first.cday + 1 );
-    uz_t gap_width = 7;
-    uz_t cal_start = name_space + gap_width;
+    uz_t* wday_of = bcore_malloc( sizeof( uz_t ) * rows ); // 7: not (yet) pinned
+    for( uz_t r = 0; r < rows; r++ ) wday_of[ r ] = 7;
+    uz_t load[ 7 ] = { 0 };
+    transfer_heap_s heap[ 7 * 7 ] = { { 0 } }; // heap[ u * 7 + v ]: moves from u to v
 
-    st_s* wdat_row = bcore_life_s_push_aware( l, st_s_create() );
+    for( uz_t r = 0; r < rows; r++ )
+    {
+        // cheapest move between weekdays
+        f3_t move[ 7 * 7 ];
+        uz_t move_row[ 7 * 7 ];
+        for( uz_t u = 0; u < 7; u++ )
+        {
+            for( uz_t v = 0; v < 7; v++ )
+            {
+                transfer_heap_s* h = &heap[ u * 7 + v ];
+                while( h->size > 0 && wday_of[ h->row[ 0 ] ] != u ) transfer_heap_s_pop( h );
+                move[ u * 7 + v ]     = ( h->size > 0 ) ? h->key[ 0 ] : INFINITY;
+                move_row[ u * 7 + v ] = ( h->size > 0 ) ? h->row[ 0 ] : 0;
+            }
+        }
+
+        // shortest paths from r to the weekdays; pred: previous weekday (7: r); via: person moving from pred to the weekday
+        f3_t dist[ 7 ];
+        uz_t pred[ 7 ];
+        uz_t via[ 7 ];
+        for( uz_t w = 0; w < 7; w++ ) dist[ w ] = pref[ r * 7 + w ], pred[ w ] = 7, via[ w ] = 0;
+        for( uz_t round = 0; round < 6; round++ )
+        {
+            for( uz_t u = 0; u < 7; u++ )
+            {
+                if( dist[ u ] == INFINITY ) continue;
+                for( uz_t v = 0; v < 7; v++ )
+                {
+                    f3_t d = dist[ u ] + move[ u * 7 + v ];
+                    if( d < dist[ v ] - 1E-9 ) dist[ v ] = d, pred[ v ] = u, via[ v ] = move_row[ u * 7 + v ];
+                }
+            }
+        }
+
+        // the path ends at the weekday with the cheapest total including its next slot
+        uz_t last = 7;
+        f3_t best = INFINITY;
+        for( uz_t w = 0; w < 7; w++ )
+        {
+            if( dist[ w ] == INFINITY ) continue;
+            f3_t d = dist[ w ] + ( f3_t )load[ w ] / days_w[ w ];
+            if( d < best ) best = d, last = w;
+        }
+        if( last == 7 ) continue; // not available on any active weekday
+
+        load[ last ]++;
+        uz_t w = last;
+        for( ; pred[ w ] < 7; w = pred[ w ] )
+        {
+            wday_of[ via[ w ] ] = w;
+            transfer_heaps_push( heap, pref, via[ w ], w );
+        }
+        wday_of[ r ] = w;
+        transfer_heaps_push( heap, pref, r, w );
+    }
+
+    for( uz_t r = 0; r < rows; r++ ) if( wday_of[ r ] < 7 ) nweekday->data[ pinned->data[ r ] ] = wday_of[ r ];
+
+    for( uz_t i = 0; i < 7 * 7; i++ ) transfer_heap_s_down( &heap[ i ] );
+    bcore_free( wday_of );
+    bcore_free( pref );
+    bcore_arr_uz_s_discard( pinned );
+}
+
+/**********************************************************************************************************************/
+// score functions
+
+/// input of a score function for one eligible candidate of an active day
+typedef struct score_input_s
+{
+    f3_t x;       // d * w; d: distance to last assignment (days), w: weight
+    f3_t share;   // weight of candidate relative to all weights
+    uz_t count;   // assignments of candidate in current trial
+    uz_t slots;   // slots of all active days up to and including the current one
+} score_input_s;
+
+/** A monotone function depends only on key( |x| ) and does not decrease with the key. Keys above 0 yield a positive score.
+ *  The solver then selects winners on the key and converts to a score only for the objective.
+ *  Keys closer than band( key ) may be ordered differently by score (rounding); they are compared by score.
+ */
+typedef struct score_function_s
+{
+    sc_t name;
+    bl_t monotone;
+    f3_t (*key)(            const assigner_s* o, f3_t x );
+    f3_t (*score_from_key)( const assigner_s* o, f3_t key );
+    f3_t (*band)(           const assigner_s* o, f3_t key );
+    f3_t (*score)(          const assigner_s* o, const score_input_s* in );
+} score_function_s;
+
+static f3_t score_key_abs( const assigner_s* o, f3_t x ) { return ( x < 0 ) ? -x : x; }
+
+// quadratic: 0.1 * (dw)^2 / ( (dw)^2 + 1 )
+static f3_t score_quadratic_from_key( const assigner_s* o, f3_t key )
+{
+    f3_t sqr = key * key;
+    return 0.1 * sqr / ( sqr + 1 );
+}
+
+static f3_t score_quadratic_band( const assigner_s* o, f3_t key ) { return key * ( key * key + 1 ) * 1E-13 + 1E-140; }
+static f3_t score_quadratic( const assigner_s* o, const score_input_s* in ) { return score_quadratic_from_key( o, score_key_abs( o, in->x ) ); }
+
+// linear: score_scale * dw
+static f3_t score_linear_from_key( const assigner_s* o, f3_t key ) { return o->score_scale * key; }
+static f3_t score_linear_band( const assigner_s* o, f3_t key ) { return key * 1E-13 + 1E-300; }
+static f3_t score_linear( const assigner_s* o, const score_input_s* in ) { return score_linear_from_key( o, score_key_abs( o, in->x ) ); }
+
+// capped: 0.1 * min( dw, score_cap ) / score_cap
+static f3_t score_capped_key( const assigner_s* o, f3_t x )
+{
+    f3_t key = score_key_abs( o, x );
+    return ( key < o->score_cap ) ? key : o->score_cap;
+}
+
+static f3_t score_capped_from_key( const assigner_s* o, f3_t key ) { return 0.1 * key / o->score_cap; }
+static f3_t score_capped( const assigner_s* o, const score_input_s* in ) { return score_capped_from_key( o, score_capped_key( o, in->x ) ); }
+
+// quota: quadratic + quota_weight * deficit; deficit: expected minus actual number of assignments so far (if positive)
+// expected: share of the slots so far (days with higher demand expect more)
+static f3_t score_quota( const assigner_s* o, const score_input_s* in )
+{
+    f3_t deficit = in->slots * in->share - ( f3_t )in->count;
+    return score_quadratic( o, in ) + ( ( deficit > 0 ) ? o->quota_weight * deficit : 0 );
+}
+
+static const score_function_s score_function_arr[] =
+{
+    { "quadratic", true,  score_key_abs,    score_quadratic_from_key, score_quadratic_band, score_quadratic },
+    { "linear",    true,  score_key_abs,    score_linear_from_key,    score_linear_band,    score_linear    },
+    { "capped",    true,  score_capped_key, score_capped_from_key,    score_linear_band,    score_capped    },
+    { "quota",     false, NULL,             NULL,                     NULL,                 score_quota     },
+};
+
+/// index in score_function_arr; empty name: default (quadratic)
+static uz_t score_function_index( sc_t name )
+{
+    if( !name || !name[ 0 ] ) return 0;
+    for( uz_t i = 0; i < sizeof( score_function_arr ) / sizeof( score_function_s ); i++ )
+    {
+        if( bcore_strcmp( score_function_arr[ i ].name, name ) == 0 ) return i;
+    }
+    ERR( "Unknown score function '%s'. Valid are quadratic, linear, capped, quota.", name );
+    return 0;
+}
+
+/// compares keys by score: 1: k1 better, 0: equal, -1: k2 better
+static s2_t score_function_s_cmp_key( const score_function_s* o, const assigner_s* assigner, f3_t k1, f3_t k2 )
+{
+    if( k1 == k2 ) return 0;
+    f3_t lo = ( k1 < k2 ) ? k1 : k2;
+    f3_t diff = k1 - k2;
+    if( ( ( diff > 0 ) ? diff : -diff ) > o->band( assigner, lo ) ) return ( diff > 0 ) ? 1 : -1;
+    f3_t s1 = o->score_from_key( assigner, k1 );
+    f3_t s2 = o->score_from_key( assigner, k2 );
+    return ( s1 > s2 ) - ( s1 < s2 );
+}
+
+/**********************************************************************************************************************/
+// trajectories: trials differ only by rank-dependent (tie) decisions
+
+/** A trajectory hash identifies the sequence of tie decisions of a trial (active day and set of winners).
+ *  Trials with equal decisions pass through identical states and produce identical results.
+ */
+static u3_t trajectory_mix( u3_t x )
+{
+    // splitmix64 finalizer
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+/// set of trajectory hashes (open addressing; 0 marks an empty entry)
+typedef struct trajectory_set_s
+{
+    u3_t* data;
+    uz_t size;
+    uz_t space; // power of two
+} trajectory_set_s;
+
+static void trajectory_set_s_down( trajectory_set_s* o )
+{
+    if( o->data ) bcore_free( o->data );
+}
+
+static bl_t trajectory_set_s_contains( const trajectory_set_s* o, u3_t h )
+{
+    if( o->space == 0 ) return false;
+    h = h ? h : 1;
+    for( uz_t i = h & ( o->space - 1 ); o->data[ i ]; i = ( i + 1 ) & ( o->space - 1 ) ) if( o->data[ i ] == h ) return true;
+    return false;
+}
+
+static void trajectory_set_s_insert( trajectory_set_s* o, u3_t h )
+{
+    h = h ? h : 1;
+    if( ( o->size + 1 ) * 2 > o->space )
+    {
+        trajectory_set_s old = *o;
+        o->space = old.space ? old.space * 2 : 64;
+        o->size  = 0;
+        o->data  = bcore_malloc( sizeof( u3_t ) * o->space );
+        memset( o->data, 0, sizeof( u3_t ) * o->space );
+        for( uz_t i = 0; i < old.space; i++ ) if( old.data[ i ] ) trajectory_set_s_insert( o, old.data[ i ] );
+        trajectory_set_s_down( &old );
+    }
+    uz_t i = h & ( o->space - 1 );
+    while( o->data[ i ] && o->data[ i ] != h ) i = ( i + 1 ) & ( o->space - 1 );
+    if( !o->data[ i ] )
+    {
+        o->data[ i ] = h;
+        o->size++;
+    }
+}
+
+static bl_t trial_s_run_explored( trial_s* o, const solver_s* solver, u2_t rseed, trajectory_set_s* explored, uz_t* days_run );
+
+/**********************************************************************************************************************/
+
+/** Best distinct trials: min-heap of at most capacity trials (the worst at the root).
+ *  Trials are distinct by the persons assigned to each day (hash); a trial equal to a retained one is not added.
+ */
+struct plan_heap_s
+{
+    uz_t capacity;
+    uz_t size;
+    trial_s** trial;
+    u3_t* hash;
+};
+
+/// hash of the persons (classes) assigned to each day (independent of the slot order within a day)
+static u3_t trial_s_plan_hash( const trial_s* o, const solver_s* solver )
+{
+    const calendar_s* calendar = &solver->calendar;
+    uz_t classes = solver->class_first.size - 1;
+    u3_t hash = 0;
+    for( uz_t day = 0; day < calendar->cday_arr.size; day++ )
+    {
+        u3_t set = 0;
+        for( uz_t slot = calendar->slot_first_arr.data[ day ]; slot < calendar->slot_first_arr.data[ day + 1 ]; slot++ )
+        {
+            uz_t idx = o->winner.data[ slot ];
+            set += trajectory_mix( ( ( idx < solver->class_of.size ) ? solver->class_of.data[ idx ] : classes ) + 1 );
+        }
+        hash = trajectory_mix( hash + 0x9e3779b97f4a7c15ull * ( day + 1 ) + set );
+    }
+    return hash;
+}
+
+/// higher score; equal scores: earlier cycle (as the best trial of solver_s_solve)
+static bl_t trial_s_better( const trial_s* a, const trial_s* b )
+{
+    return ( a->score > b->score ) || ( a->score == b->score && a->cycle < b->cycle );
+}
+
+static void plan_heap_s_down( plan_heap_s* o )
+{
+    for( uz_t i = 0; i < o->size; i++ ) trial_s_discard( o->trial[ i ] );
+    if( o->trial ) bcore_free( o->trial );
+    if( o->hash  ) bcore_free( o->hash );
+}
+
+static void plan_heap_s_swap( plan_heap_s* o, uz_t i, uz_t j )
+{
+    trial_s* t = o->trial[ i ];
+    o->trial[ i ] = o->trial[ j ];
+    o->trial[ j ] = t;
+    u3_t h = o->hash[ i ];
+    o->hash[ i ] = o->hash[ j ];
+    o->hash[ j ] = h;
+}
+
+/// restores the heap below i within [0, size)
+static void plan_heap_s_sift_down( plan_heap_s* o, uz_t i, uz_t size )
+{
+    for( ;; )
+    {
+        uz_t worst = i;
+        uz_t l = 2 * i + 1;
+        uz_t r = l + 1;
+        if( l < size && trial_s_better( o->trial[ worst ], o->trial[ l ] ) ) worst = l;
+        if( r < size && trial_s_better( o->trial[ worst ], o->trial[ r ] ) ) worst = r;
+        if( worst == i ) return;
+        plan_heap_s_swap( o, i, worst );
+        i = worst;
+    }
+}
+
+static void plan_heap_s_offer( plan_heap_s* o, const solver_s* solver, const trial_s* trial )
+{
+    if( o->capacity == 0 ) return;
+    if( o->size == o->capacity && !trial_s_better( trial, o->trial[ 0 ] ) ) return;
+    u3_t hash = trial_s_plan_hash( trial, solver );
+    for( uz_t i = 0; i < o->size; i++ ) if( o->hash[ i ] == hash ) return;
+
+    if( !o->trial )
+    {
+        o->trial = bcore_malloc( sizeof( trial_s* ) * o->capacity );
+        o->hash  = bcore_malloc( sizeof( u3_t ) * o->capacity );
+    }
+
+    if( o->size < o->capacity )
+    {
+        uz_t i = o->size++;
+        o->trial[ i ] = trial_s_create();
+        trial_s_copy_state( o->trial[ i ], trial );
+        o->hash[ i ] = hash;
+        for( ; i > 0 && trial_s_better( o->trial[ ( i - 1 ) / 2 ], o->trial[ i ] ); i = ( i - 1 ) / 2 ) plan_heap_s_swap( o, i, ( i - 1 ) / 2 );
+    }
+    else
+    {
+        // replaces the worst
+        trial_s_copy_state( o->trial[ 0 ], trial );
+        o->hash[ 0 ] = hash;
+        plan_heap_s_sift_down( o, 0, o->size );
+    }
+}
+
+/// orders trials best first (the heap order is lost)
+static void plan_heap_s_sort( plan_heap_s* o )
+{
+    for( uz_t n = o->size; n > 1; n-- )
+    {
+        plan_heap_s_swap( o, 0, n - 1 );
+        plan_heap_s_sift_down( o, 0, n - 1 );
+    }
+}
+
+/**********************************************************************************************************************/
+// equivalence classes
+
+/** Persons are interchangeable for the solver when they have equal weight, equal eligible days, no assigned dates and a
+ *  weekday that cannot change during a trial (fixed or not always_same_workday). With assigner.collapse_classes such
+ *  persons form a class; a trial keeps the members of each class in a queue, least recently assigned first, and
+ *  evaluates only its front members. Otherwise each person is a class of its own.
+ */
+static bl_t solver_s_class_member( const solver_s* o, uz_t person )
+{
+    const model_person_s* p = &o->model.persons.data[ person ];
+    return p->assigned_size == 0 && ( o->nweekday.data[ person ] < 7 || !p->always_same_workday );
+}
+
+static bl_t solver_s_interchangeable( const solver_s* o, uz_t a, uz_t b )
+{
+    const availability_s* availability = &o->availability;
+    if( o->model.persons.data[ a ].weight != o->model.persons.data[ b ].weight ) return false;
+    if( o->nweekday.data[ a ] != o->nweekday.data[ b ] ) return false;
+    const uz_t* row_a = availability->bits.data + a * availability->words;
+    const uz_t* row_b = availability->bits.data + b * availability->words;
+    return memcmp( row_a, row_b, sizeof( uz_t ) * availability->words ) == 0;
+}
+
+static u3_t solver_s_class_hash( const solver_s* o, uz_t person )
+{
+    const availability_s* availability = &o->availability;
+    const uz_t* row = availability->bits.data + person * availability->words;
+    u3_t weight;
+    memcpy( &weight, &o->model.persons.data[ person ].weight, sizeof( weight ) );
+    u3_t hash = trajectory_mix( weight + o->nweekday.data[ person ] );
+    for( uz_t i = 0; i < availability->words; i++ ) hash = trajectory_mix( hash + row[ i ] );
+    return hash;
+}
+
+/// classes are numbered in the order of their first member; eligible classes per day are listed by their first member
+static void solver_s_setup_classes( solver_s* o )
+{
+    const availability_s* availability = &o->availability;
+    uz_t persons = o->model.persons.size;
+    uz_t classes = 0;
+    bcore_arr_uz_s_fill( &o->class_of, persons, 0 );
+
+    if( o->assigner.collapse_classes )
+    {
+        // open addressing table of first members + 1 (0: empty)
+        uz_t table_size = 16;
+        while( table_size < persons * 2 ) table_size *= 2;
+        uz_t mask = table_size - 1;
+        bcore_arr_uz_s* table = bcore_arr_uz_s_create();
+        bcore_arr_uz_s_fill( table, table_size, 0 );
+        for( uz_t i = 0; i < persons; i++ )
+        {
+            o->class_of.data[ i ] = classes;
+            if( !solver_s_class_member( o, i ) )
+            {
+                classes++;
+                continue;
+            }
+            for( uz_t idx = solver_s_class_hash( o, i ) & mask; ; idx = ( idx + 1 ) & mask )
+            {
+                if( table->data[ idx ] == 0 )
+                {
+                    table->data[ idx ] = i + 1;
+                    classes++;
+                    break;
+                }
+                uz_t first = table->data[ idx ] - 1;
+                if( solver_s_interchangeable( o, first, i ) )
+                {
+                    o->class_of.data[ i ] = o->class_of.data[ first ];
+                    break;
+                }
+            }
+        }
+        bcore_arr_uz_s_discard( table );
+    }
+    else
+    {
+        for( uz_t i = 0; i < persons; i++ ) o->class_of.data[ i ] = i;
+        classes = persons;
+    }
+
+    bcore_arr_uz_s_fill( &o->class_first, classes + 1, 0 );
+    for( uz_t i = 0; i < persons; i++ ) o->class_first.data[ o->class_of.data[ i ] + 1 ]++;
+    for( uz_t c = 0; c < classes; c++ ) o->class_first.data[ c + 1 ] += o->class_first.data[ c ];
+
+    bcore_arr_uz_s_fill( &o->class_members, persons, 0 );
+    bcore_arr_uz_s* fill = bcore_arr_uz_s_clone( &o->class_first );
+    for( uz_t i = 0; i < persons; i++ ) o->class_members.data[ fill->data[ o->class_of.data[ i ] ]++ ] = i;
+    bcore_arr_uz_s_discard( fill );
+
+    bcore_arr_uz_s_clear( &o->day_class_first );
+    bcore_arr_uz_s_clear( &o->day_classes );
+    bcore_arr_uz_s_set_space( &o->day_class_first, availability->days + 1 );
+    for( uz_t day = 0; day < availability->days; day++ )
+    {
+        bcore_arr_uz_s_push( &o->day_class_first, o->day_classes.size );
+        for( uz_t j = availability->day_first.data[ day ]; j < availability->day_first.data[ day + 1 ]; j++ )
+        {
+            uz_t idx = availability->day_persons.data[ j ];
+            uz_t c = o->class_of.data[ idx ];
+            if( o->class_members.data[ o->class_first.data[ c ] ] == idx ) bcore_arr_uz_s_push( &o->day_classes, c );
+        }
+    }
+    bcore_arr_uz_s_push( &o->day_class_first, o->day_classes.size );
+}
+
+/**********************************************************************************************************************/
+
+static sc_t solver_s_def = "solver_s = "
+"{"
+    "aware_t _;                  "
+    "assigner_s     assigner;    "
+    "model_s        model;       "
+    "calendar_s     calendar;    "
+    "availability_s availability;"
+    "uz_t score_function;        "
+    "f3_t weight_sum;            "
+    "bcore_arr_uz_s nweekday;    "
+    "bcore_arr_uz_s class_of;    "
+    "bcore_arr_uz_s class_first; "
+    "bcore_arr_uz_s class_members;"
+    "bcore_arr_uz_s day_class_first;"
+    "bcore_arr_uz_s day_classes; "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( solver_s, solver_s_def )
+
+/// recomputes data depending on model and calendar
+static void solver_s_update( solver_s* o )
+{
+    availability_s_setup( &o->availability, &o->calendar, &o->model );
+    if( o->assigner.pin_weekdays )
+    {
+        pin_weekdays( &o->nweekday, &o->calendar, &o->model, &o->availability );
+    }
+    else
+    {
+        bcore_arr_uz_s_fill( &o->nweekday, o->model.persons.size, 7 );
+        for( uz_t i = 0; i < o->model.persons.size; i++ ) o->nweekday.data[ i ] = o->model.persons.data[ i ].assigned_nweekday;
+    }
+    solver_s_setup_classes( o );
+}
+
+void solver_s_setup( solver_s* o, const assigner_s* assigner, const assignment_s* src, period_s period )
+{
+    assigner_s_copy( &o->assigner, assigner );
+    o->score_function = score_function_index( o->assigner.score_function.sc );
+    if( o->assigner.score_scale  <= 0 ) ERR( "score_scale must be positive (is %g).", o->assigner.score_scale );
+    if( o->assigner.score_cap    <= 0 ) ERR( "score_cap must be positive (is %g).", o->assigner.score_cap );
+    if( o->assigner.quota_weight <  0 ) ERR( "quota_weight must not be negative (is %g).", o->assigner.quota_weight );
+    calendar_s_setup( &o->calendar, &o->assigner, period );
+    solver_s_set_assignment( o, src );
+}
+
+void solver_s_set_period( solver_s* o, period_s period )
+{
+    calendar_s_setup( &o->calendar, &o->assigner, period );
+    solver_s_update( o );
+}
+
+void solver_s_set_assignment( solver_s* o, const assignment_s* src )
+{
+    model_s_setup( &o->model, src );
+    o->weight_sum = 0;
+    for( uz_t i = 0; i < o->model.persons.size; i++ ) o->weight_sum += o->model.persons.data[ i ].weight;
+    solver_s_update( o );
+}
+
+u2_t solver_seed( u2_t rseed, uz_t cycle )
+{
+    u2_t rval = bcore_xsg3_u2( rseed );
+    for( uz_t i = 0; i <= cycle; i++ ) rval = bcore_xsg3_u2( rval );
+    return rval;
+}
+
+/**********************************************************************************************************************/
+
+bl_t solve_control_s_cancelled( const solve_control_s* o )
+{
+    return o && o->cancel && __atomic_load_n( o->cancel, __ATOMIC_RELAXED );
+}
+
+void progress_s_begin( progress_s* o, const solve_control_s* control, uz_t total )
+{
+    o->control     = ( control && control->progress ) ? control : NULL;
+    o->total       = total;
+    o->time_start  = guard_time_ms();
+    o->time_report = o->time_start;
+}
+
+void progress_s_update( progress_s* o, uz_t done, f3_t best_score, bl_t finished )
+{
+    if( !o->control ) return;
+    f3_t time = guard_time_ms();
+    if( !finished && time - o->time_report < o->control->progress_ms ) return;
+    o->time_report = time;
+    o->control->progress( o->control->progress_arg, done, o->total, best_score, time - o->time_start );
+}
+
+/**********************************************************************************************************************/
+
+bl_t solver_s_solve_range( const solver_s* o, u2_t rseed, uz_t first, uz_t end, trial_s* best, const solve_control_s* control, solve_stats_s* stats )
+{
+    if( stats ) memset( stats, 0, sizeof( *stats ) );
+    if( first >= end ) return false;
+    trial_s* trial = trial_s_create();
+    trajectory_set_s explored = { 0 };
+    progress_s progress;
+    progress_s_begin( &progress, control, end - first );
+    uz_t days = o->calendar.cday_arr.size;
+    f3_t best_score = -1E20;
+    bl_t found = true;
+    u2_t rval = solver_seed( rseed, first );
+    uz_t i = first;
+    for( ; i < end; i++ )
+    {
+        if( solve_control_s_cancelled( control ) )
+        {
+            found = false;
+            if( stats ) stats->cancelled = true;
+            break;
+        }
+        if( i > first ) rval = bcore_xsg3_u2( rval );
+        uz_t days_run = 0;
+        bl_t completed = trial_s_run_explored( trial, o, rval, &explored, &days_run );
+        if( stats )
+        {
+            stats->trials++;
+            stats->days += days_run;
+            if( !completed ) stats->duplicates++;
+            if( !completed ) stats->days_skipped += days - days_run;
+        }
+
+        // a duplicate has the score of an earlier trial and cannot replace best
+        if( completed )
+        {
+            trial->cycle = i;
+            if( trial->score > best_score )
+            {
+                best_score = trial->score;
+                trial_s_copy_state( best, trial );
+            }
+            if( control && control->plans ) plan_heap_s_offer( control->plans, o, trial );
+        }
+        progress_s_update( &progress, i - first + 1, best_score, false );
+    }
+    progress_s_update( &progress, i - first, best_score, true );
+    if( stats ) stats->distinct = explored.size;
+    trajectory_set_s_down( &explored );
+    trial_s_discard( trial );
+    return found;
+}
+
+void solver_s_solve( const solver_s* o, u2_t rseed, uz_t cycles, trial_s* best )
+{
+    if( assigner_s_branch_search( &o->assigner ) )
+    {
+        solver_s_solve_branch( o, rseed, cycles, best, NULL, NULL );
+    }
+    else
+    {
+        solver_s_solve_range( o, rseed, 0, cycles, best, NULL, NULL );
+    }
+}
+
+assignment_s* solver_s_create_assignment( const solver_s* o, const assignment_s* src, const trial_s* trial )
+{
+    // persons in trial order: element i is a copy of src person order[ i ]
+    assignment_s* assignment = assignment_s_create();
+    assignment_s_reserve( assignment, src->size );
+    for( uz_t i = 0; i < src->size; i++ ) assignment->data[ assignment->size++ ] = person_s_clone( src->data[ trial->order.data[ i ] ] );
+
+    // capacity for the dates of this trial
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        date_arr_s* dates = &assignment->data[ trial->rank.data[ i ] ]->assigned_dates;
+        date_arr_s_reserve( dates, dates->size + trial->count.data[ i ] );
+    }
+
+    for( uz_t day = 0; day < o->calendar.cday_arr.size; day++ )
+    {
+        uz_t cday = o->calendar.cday_arr.data[ day ];
+        for( uz_t slot = o->calendar.slot_first_arr.data[ day ]; slot < o->calendar.slot_first_arr.data[ day + 1 ]; slot++ )
+        {
+            uz_t idx = trial->winner.data[ slot ];
+            if( idx >= src->size ) continue;
+            person_s* p = assignment->data[ trial->rank.data[ idx ] ];
+            if( !date_arr_s_matches( &p->assigned_dates, cday ) ) date_arr_s_push_cday( &p->assigned_dates, cday );
+        }
+    }
+
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        assignment->data[ trial->rank.data[ i ] ]->assigned_nweekday = trial->nweekday.data[ i ];
+    }
+
+    return assignment;
+}
+
+/**********************************************************************************************************************/
+
+static sc_t trial_s_def = "trial_s = "
+"{"
+    "aware_t _;               "
+    "u2_t rseed;              "
+    "uz_t cycle;              "
+    "f3_t score;              "
+    "uz_t fail_count;         "
+    "bcore_arr_uz_s order;    "
+    "bcore_arr_uz_s rank;     "
+    "bcore_arr_uz_s last_cday;"
+    "bcore_arr_uz_s cursor;   "
+    "bcore_arr_uz_s nweekday; "
+    "bcore_arr_uz_s winner;   "
+    "bcore_arr_uz_s count;    "
+    "bcore_arr_uz_s queue;    "
+    "bcore_arr_uz_s queue_pos;"
+    "bcore_arr_uz_s head;     "
+    "u3_t trajectory;         "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( trial_s, trial_s_def )
+
+static void arr_uz_copy( bcore_arr_uz_s* o, const bcore_arr_uz_s* src )
+{
+    bcore_arr_uz_s_set_size( o, src->size );
+    if( src->size > 0 ) memcpy( o->data, src->data, sizeof( uz_t ) * src->size );
+}
+
+void trial_s_copy_state( trial_s* o, const trial_s* src )
+{
+    o->rseed      = src->rseed;
+    o->cycle      = src->cycle;
+    o->score      = src->score;
+    o->fail_count = src->fail_count;
+    o->trajectory = src->trajectory;
+    arr_uz_copy( &o->order,     &src->order );
+    arr_uz_copy( &o->rank,      &src->rank );
+    arr_uz_copy( &o->last_cday, &src->last_cday );
+    arr_uz_copy( &o->cursor,    &src->cursor );
+    arr_uz_copy( &o->nweekday,  &src->nweekday );
+    arr_uz_copy( &o->winner,    &src->winner );
+    arr_uz_copy( &o->count,     &src->count );
+    arr_uz_copy( &o->queue,     &src->queue );
+    arr_uz_copy( &o->queue_pos, &src->queue_pos );
+    arr_uz_copy( &o->head,      &src->head );
+}
+
+/** Evaluates an eligible person for an active day:
+ *  Returns false when the person is fixed to a different weekday.
+ *  *x: INFINITY when the person is already assigned on that day, otherwise d * w
+ *  with d: distance to last assignment (days), w: weight.
+ *  Eligibility implies that preferences match with weight unless the day is already assigned.
+ */
+static bl_t trial_s_candidate( trial_s* o, const solver_s* solver, uz_t person, uz_t day, f3_t* x )
+{
+    const model_person_s* p = &solver->model.persons.data[ person ];
+    uz_t cday = solver->calendar.cday_arr.data[ day ];
+    uz_t nweekday = o->nweekday.data[ person ];
+    if( nweekday < 7 && nweekday != wday_from_cday( cday ) ) return false;
+
+    const uz_t* assigned = model_s_assigned( &solver->model, person );
+    uz_t cursor    = o->cursor.data[ person ];
+    uz_t last_cday = o->last_cday.data[ person ];
+    while( cursor < p->assigned_size && assigned[ cursor ] < cday )
+    {
+        last_cday = ( assigned[ cursor ] > last_cday ) ? assigned[ cursor ] : last_cday;
+        cursor++;
+    }
+    o->cursor.data[ person ]    = cursor;
+    o->last_cday.data[ person ] = last_cday;
+
+    if( cursor < p->assigned_size && assigned[ cursor ] == cday )
+    {
+        *x = INFINITY;
+        return true;
+    }
+
+    // diff: distance from last assignment in cdays
+    f3_t diff = ( f3_t )( ( cday > last_cday ) ? ( cday - last_cday ) : 0 );
+    *x = diff * p->weight;
+    return true;
+}
+
+/// compares candidate values: keys of a monotone score function (by_key) or scores
+static s2_t trial_s_cmp_value( const score_function_s* fn, const assigner_s* assigner, bl_t by_key, f3_t v1, f3_t v2 )
+{
+    if( by_key ) return score_function_s_cmp_key( fn, assigner, v1, v2 );
+    return ( v1 > v2 ) - ( v1 < v2 );
+}
+
+/** Value of an eligible person for an active day used for selection (returns false if not a candidate):
+ *  INFINITY when already assigned on that day; otherwise the key (monotone score function) or the score.
+ */
+static bl_t trial_s_value( trial_s* o, const solver_s* solver, const score_function_s* fn, uz_t idx, uz_t day, f3_t* value )
+{
+    score_input_s in;
+    if( !trial_s_candidate( o, solver, idx, day, &in.x ) ) return false;
+    if( in.x == INFINITY )
+    {
+        *value = INFINITY;
+    }
+    else if( fn->monotone )
+    {
+        *value = fn->key( &solver->assigner, in.x );
+    }
+    else
+    {
+        in.share = ( solver->weight_sum > 0 ) ? solver->model.persons.data[ idx ].weight / solver->weight_sum : 0;
+        in.count = o->count.data[ idx ];
+        in.slots = solver->calendar.slot_first_arr.data[ day + 1 ];
+        *value = fn->score( &solver->assigner, &in );
+    }
+    return true;
+}
+
+/// position of person idx in the queue of its class (0: front)
+static inline uz_t trial_s_queue_index( const trial_s* o, const solver_s* solver, uz_t c, uz_t idx )
+{
+    uz_t first = solver->class_first.data[ c ];
+    uz_t size  = solver->class_first.data[ c + 1 ] - first;
+    uz_t index = o->queue_pos.data[ idx ] - first + size - o->head.data[ c ];
+    return ( index >= size ) ? index - size : index;
+}
+
+/// order of candidates with equal values: members of the same class by queue position, others by rank
+static bl_t trial_s_before( const trial_s* o, const solver_s* solver, uz_t a, uz_t b )
+{
+    uz_t c = solver->class_of.data[ a ];
+    if( c != solver->class_of.data[ b ] ) return o->rank.data[ a ] < o->rank.data[ b ];
+    return trial_s_queue_index( o, solver, c, a ) < trial_s_queue_index( o, solver, c, b );
+}
+
+/** Inserts candidate idx with value into the descending list top_idx, top_val of size *n (capacity k) if it ranks among the k best.
+ *  Ties are resolved by trial_s_before. Only candidates with a value above 0 are eligible. Returns true when inserted.
+ *  *tie is set when rank was consulted; whether that happens does not depend on rank.
+ */
+static bl_t trial_s_insert_top
+(
+    const trial_s* o, const solver_s* solver, const score_function_s* fn,
+    uz_t idx, f3_t value, uz_t k, uz_t* top_idx, f3_t* top_val, uz_t* n, bl_t* tie
+)
+{
+    const assigner_s* assigner = &solver->assigner;
+    if( trial_s_cmp_value( fn, assigner, fn->monotone, value, 0 ) <= 0 ) return false;
+    uz_t pos = *n;
+    while( pos > 0 )
+    {
+        s2_t cmp = trial_s_cmp_value( fn, assigner, fn->monotone, value, top_val[ pos - 1 ] );
+        if( cmp == 0 ) *tie = true;
+        if( cmp < 0 || ( cmp == 0 && trial_s_before( o, solver, top_idx[ pos - 1 ], idx ) ) ) break;
+        pos--;
+    }
+    if( pos >= k ) return false;
+    if( *n < k ) ( *n )++;
+    for( uz_t m = *n - 1; m > pos; m-- )
+    {
+        top_idx[ m ] = top_idx[ m - 1 ];
+        top_val[ m ] = top_val[ m - 1 ];
+    }
+    top_idx[ pos ] = idx;
+    top_val[ pos ] = value;
+    return true;
+}
+
+/** Selects up to k winners of an active day in one pass over the eligible classes.
+ *  Members of a class are offered in queue order up to the first one not among the k best (values do not increase
+ *  along a queue), hence the winners of a class are the front of its queue.
+ *  top_idx receives the winners in descending order; returns the sum of their scores; *n: number of winners.
+ *  *tie: the selection depended on rank.
+ */
+static f3_t trial_s_select( trial_s* o, const solver_s* solver, const score_function_s* fn, uz_t day, uz_t k, uz_t* top_idx, f3_t* top_val, uz_t* n, bl_t* tie )
+{
+    *n = 0;
+    *tie = false;
+
+    for( uz_t j = solver->day_class_first.data[ day ]; j < solver->day_class_first.data[ day + 1 ]; j++ )
+    {
+        uz_t c     = solver->day_classes.data[ j ];
+        uz_t first = solver->class_first.data[ c ];
+        uz_t size  = solver->class_first.data[ c + 1 ] - first;
+        uz_t slot  = o->head.data[ c ];
+        for( uz_t m = 0; m < size && m < k; m++ )
+        {
+            uz_t idx = o->queue.data[ first + slot ];
+            f3_t value;
+            if( !trial_s_value( o, solver, fn, idx, day, &value ) ) break;
+            if( !trial_s_insert_top( o, solver, fn, idx, value, k, top_idx, top_val, n, tie ) ) break;
+            if( ++slot == size ) slot = 0;
+        }
+    }
+
+    f3_t score = 0;
+    for( uz_t m = 0; m < *n; m++ )
+    {
+        f3_t v = top_val[ m ];
+        score += ( v == INFINITY ) ? 1.0 : fn->monotone ? fn->score_from_key( &solver->assigner, v ) : v;
+    }
+    return score;
+}
+
+/// initializes the state of a trial with the random order of persons derived from rseed
+static void trial_s_reset( trial_s* o, const solver_s* solver, u2_t rseed )
+{
+    uz_t persons = solver->model.persons.size;
+    o->rseed = rseed;
+
+    {
+        bcore_arr_uz_s* permutation = bcore_arr_uz_s_create_random_permutation( bcore_xsg_u2, rseed, persons );
+        arr_uz_copy( &o->order, permutation );
+        bcore_arr_uz_s_discard( permutation );
+    }
+
+    bcore_arr_uz_s_fill( &o->rank,      persons, 0 );
+    bcore_arr_uz_s_fill( &o->last_cday, persons, 0 );
+    bcore_arr_uz_s_fill( &o->cursor,    persons, 0 );
+    bcore_arr_uz_s_fill( &o->nweekday,  persons, 0 );
+    bcore_arr_uz_s_fill( &o->count,     persons, 0 );
+    bcore_arr_uz_s_fill( &o->winner,    calendar_s_slots( &solver->calendar ), persons );
+    for( uz_t i = 0; i < persons; i++ )
+    {
+        o->rank.data[ o->order.data[ i ] ] = i;
+        o->nweekday.data[ i ] = solver->nweekday.data[ i ];
+    }
+
+    // queues in rank order (head serves as fill counter)
+    uz_t classes = solver->class_first.size - 1;
+    bcore_arr_uz_s_fill( &o->queue,     persons, 0 );
+    bcore_arr_uz_s_fill( &o->queue_pos, persons, 0 );
+    bcore_arr_uz_s_fill( &o->head,      classes, 0 );
+    for( uz_t i = 0; i < persons; i++ )
+    {
+        uz_t idx = o->order.data[ i ];
+        uz_t c   = solver->class_of.data[ idx ];
+        uz_t pos = solver->class_first.data[ c ] + o->head.data[ c ]++;
+        o->queue.data[ pos ]     = idx;
+        o->queue_pos.data[ idx ] = pos;
+    }
+    bcore_arr_uz_s_fill( &o->head, classes, 0 );
+
+    o->score = 0;
+    o->fail_count = 0;
+    o->trajectory = 0;
+}
+
+/// state of a trial at the start of a day, shared by the branches taken on that day
+typedef struct branch_snapshot_s
+{
+    trial_s* trial;
+    uz_t refs; // pending branches
+} branch_snapshot_s;
+
+/// a branch: the snapshot with the ranks of idx and last swapped
+typedef struct branch_s
+{
+    branch_snapshot_s* snapshot;
+    uz_t day;
+    uz_t idx;
+    uz_t last;
+} branch_s;
+
+/// pending branches of the branch search (first in, first out)
+typedef struct branch_queue_s
+{
+    branch_s* data;
+    uz_t head, size, space;
+    uz_t capacity;    // branches accepted in total
+    uz_t pushed;
+} branch_queue_s;
+
+static branch_snapshot_s* branch_snapshot_s_create( const trial_s* trial )
+{
+    branch_snapshot_s* o = bcore_malloc( sizeof( branch_snapshot_s ) );
+    o->trial = trial_s_create();
+    trial_s_copy_state( o->trial, trial );
+    o->refs = 0;
+    return o;
+}
+
+static void branch_snapshot_s_release( branch_snapshot_s* o )
+{
+    if( --o->refs > 0 ) return;
+    trial_s_discard( o->trial );
+    bcore_free( o );
+}
+
+static void branch_queue_s_push( branch_queue_s* o, branch_snapshot_s* snapshot, uz_t day, uz_t idx, uz_t last )
+{
+    if( o->size == o->space )
+    {
+        o->space = o->space ? o->space * 2 : 64;
+        o->data = bcore_realloc( o->data, sizeof( branch_s ) * o->space );
+    }
+    o->data[ o->size++ ] = ( branch_s ){ .snapshot = snapshot, .day = day, .idx = idx, .last = last };
+    snapshot->refs++;
+    o->pushed++;
+}
+
+/// sets trial to the next branch and returns its day
+static uz_t branch_queue_s_pop( branch_queue_s* o, trial_s* trial )
+{
+    const branch_s* b = &o->data[ o->head++ ];
+    trial_s_copy_state( trial, b->snapshot->trial );
+    uz_t rank_idx  = trial->rank.data[ b->idx ];
+    uz_t rank_last = trial->rank.data[ b->last ];
+    trial->rank.data[ b->idx ]  = rank_last;
+    trial->rank.data[ b->last ] = rank_idx;
+    trial->order.data[ rank_last ] = b->idx;
+    trial->order.data[ rank_idx ]  = b->last;
+    branch_snapshot_s_release( b->snapshot );
+    return b->day;
+}
+
+static void branch_queue_s_down( branch_queue_s* o )
+{
+    for( uz_t i = o->head; i < o->size; i++ ) branch_snapshot_s_release( o->data[ i ].snapshot );
+    if( o->data ) bcore_free( o->data );
+}
+
+/** Queues a branch for each candidate tying with the last winner of a full day without being selected.
+ *  The branch swaps the ranks of that candidate and the last winner, so that it wins instead.
+ *  Per class only the first member not selected is a candidate; members of the class of the last winner are not.
+ *  o is the state after selection (before winners and the score of day are applied), which equals the state at the start of day.
+ *  Branches of the same day share one snapshot of o and only record the swapped pair.
+ */
+static void trial_s_push_branches( trial_s* o, const solver_s* solver, const score_function_s* fn, uz_t day, uz_t k, const uz_t* top_idx, const f3_t* top_val, uz_t n, branch_queue_s* queue )
+{
+    if( n < k ) return; // all eligible candidates won
+    uz_t last = top_idx[ n - 1 ];
+    branch_snapshot_s* snapshot = NULL; // shared by all branches of this day
+    for( uz_t j = solver->day_class_first.data[ day ]; j < solver->day_class_first.data[ day + 1 ] && queue->pushed < queue->capacity; j++ )
+    {
+        uz_t c = solver->day_classes.data[ j ];
+        if( c == solver->class_of.data[ last ] ) continue;
+
+        // first member not selected (winners of a class are the front of its queue)
+        uz_t first = solver->class_first.data[ c ];
+        uz_t size  = solver->class_first.data[ c + 1 ] - first;
+        uz_t slot  = o->head.data[ c ];
+        uz_t idx   = 0;
+        bl_t selected = true;
+        for( uz_t m = 0; m < size && selected; m++ )
+        {
+            idx = o->queue.data[ first + slot ];
+            selected = false;
+            for( uz_t w = 0; w < n; w++ ) selected = selected || top_idx[ w ] == idx;
+            if( ++slot == size ) slot = 0;
+        }
+        if( selected ) continue;
+
+        f3_t value;
+        if( !trial_s_value( o, solver, fn, idx, day, &value ) ) continue;
+        if( trial_s_cmp_value( fn, &solver->assigner, fn->monotone, value, top_val[ n - 1 ] ) != 0 ) continue;
+
+        if( !snapshot ) snapshot = branch_snapshot_s_create( o );
+        branch_queue_s_push( queue, snapshot, day, idx, last );
+    }
+}
+
+/** Runs active days [first_day, days) from the current state and finalizes the score.
+ *  A person already assigned on a day scores highest (1.0 in the objective). Ties are resolved by rank.
+ *  explored (optional): final trajectories of completed trials; the trial is aborted (returns false) as soon as it
+ *  repeats one of them. Otherwise its final trajectory is added. days_run (optional): active days evaluated.
+ *  queue (optional): receives branches at ties on days from branch_day on.
+ */
+static bl_t trial_s_run_days( trial_s* o, const solver_s* solver, uz_t first_day, trajectory_set_s* explored, branch_queue_s* queue, uz_t branch_day, uz_t* days_run )
+{
+    const model_s* model = &solver->model;
+    const calendar_s* calendar = &solver->calendar;
+    const score_function_s* fn = &score_function_arr[ solver->score_function ];
+    uz_t days  = calendar->cday_arr.size;
+    uz_t slots = calendar_s_slots( calendar );
+
+    uz_t max_demand = 1;
+    for( uz_t day = 0; day < days; day++ )
+    {
+        uz_t demand = calendar_s_demand( calendar, day );
+        max_demand = ( demand > max_demand ) ? demand : max_demand;
+    }
+    uz_t* top_idx = bcore_malloc( sizeof( uz_t ) * max_demand );
+    f3_t* top_val = bcore_malloc( sizeof( f3_t ) * max_demand );
+
+    bl_t repeated = explored && trajectory_set_s_contains( explored, o->trajectory );
+    uz_t day = first_day;
+
+    for( ; day < days && !repeated; day++ )
+    {
+        uz_t cday   = calendar->cday_arr.data[ day ];
+        uz_t slot   = calendar->slot_first_arr.data[ day ];
+        uz_t demand = calendar_s_demand( calendar, day );
+        uz_t filled = 0;
+        bl_t tie = false;
+
+        // days without candidates are provably unfillable
+        f3_t day_score = trial_s_select( o, solver, fn, day, demand, top_idx, top_val, &filled, &tie );
+
+        if( tie )
+        {
+            // branches re-run this day: they are taken before its score is added
+            if( queue && day >= branch_day ) trial_s_push_branches( o, solver, fn, day, demand, top_idx, top_val, filled, queue );
+
+            // the set of winners does not depend on their order in the slots
+            u3_t set = 0;
+            for( uz_t m = 0; m < filled; m++ ) set += trajectory_mix( top_idx[ m ] + 1 );
+            o->trajectory = trajectory_mix( o->trajectory + 0x9e3779b97f4a7c15ull * ( day + 1 ) + set );
+            repeated = explored && trajectory_set_s_contains( explored, o->trajectory );
+        }
+
+        for( uz_t m = 0; m < filled; m++ )
+        {
+            uz_t idx = top_idx[ m ];
+            o->winner.data[ slot + m ] = idx;
+            o->last_cday.data[ idx ] = cday;
+            o->count.data[ idx ]++;
+            if( o->nweekday.data[ idx ] >= 7 && model->persons.data[ idx ].always_same_workday ) o->nweekday.data[ idx ] = wday_from_cday( cday );
+
+            // the winner moves from the front to the back of its class queue
+            uz_t c = solver->class_of.data[ idx ];
+            if( ++o->head.data[ c ] == solver->class_first.data[ c + 1 ] - solver->class_first.data[ c ] ) o->head.data[ c ] = 0;
+        }
+        o->score += day_score;
+        o->fail_count += demand - filled;
+    }
+
+    bcore_free( top_idx );
+    bcore_free( top_val );
+    if( days_run ) *days_run = day - first_day;
+
+    if( repeated )
+    {
+        o->fail_count = 0;
+        o->score = -INFINITY;
+        return false;
+    }
+
+    if( explored ) trajectory_set_s_insert( explored, o->trajectory );
+    o->score = ( slots > 0 ) ? ( o->score / slots ) - o->fail_count : 0;
+    return true;
+}
+
+/** Runs a trial: Assigns each slot of an active day to the eligible persons with the highest scores (one person per slot).
+ *  Ties are resolved by a random order of persons derived from rseed.
+ *  explored, days_run: see trial_s_run_days
+ */
+static bl_t trial_s_run_explored( trial_s* o, const solver_s* solver, u2_t rseed, trajectory_set_s* explored, uz_t* days_run )
+{
+    trial_s_reset( o, solver, rseed );
+    return trial_s_run_days( o, solver, 0, explored, NULL, 0, days_run );
+}
+
+void trial_s_run( trial_s* o, const solver_s* solver, u2_t rseed )
+{
+    trial_s_run_explored( o, solver, rseed, NULL, NULL );
+}
+
+/// final score of the winners of o re-evaluated from the start of the period (selftest)
+static f3_t trial_s_replay_score( const trial_s* o, const solver_s* solver )
+{
+    const model_s* model = &solver->model;
+    const calendar_s* calendar = &solver->calendar;
+    const score_function_s* fn = &score_function_arr[ solver->score_function ];
+    uz_t persons = model->persons.size;
+    uz_t slots   = calendar_s_slots( calendar );
+
+    trial_s* t = trial_s_create();
+    trial_s_reset( t, solver, o->rseed );
+    for( uz_t day = 0; day < calendar->cday_arr.size; day++ )
+    {
+        uz_t cday = calendar->cday_arr.data[ day ];
+        f3_t day_score = 0;
+        for( uz_t slot = calendar->slot_first_arr.data[ day ]; slot < calendar->slot_first_arr.data[ day + 1 ]; slot++ )
+        {
+            uz_t idx = o->winner.data[ slot ];
+            f3_t v;
+            if( idx >= persons || !trial_s_value( t, solver, fn, idx, day, &v ) )
+            {
+                t->fail_count++;
+                continue;
+            }
+            day_score += ( v == INFINITY ) ? 1.0 : fn->monotone ? fn->score_from_key( &solver->assigner, v ) : v;
+            t->last_cday.data[ idx ] = cday;
+            t->count.data[ idx ]++;
+            if( t->nweekday.data[ idx ] >= 7 && model->persons.data[ idx ].always_same_workday ) t->nweekday.data[ idx ] = wday_from_cday( cday );
+        }
+        t->score += day_score;
+    }
+    f3_t score = ( slots > 0 ) ? ( t->score / slots ) - t->fail_count : 0;
+    trial_s_discard( t );
+    return score;
+}
+
+void solver_s_solve_branch( const solver_s* o, u2_t rseed, uz_t budget, trial_s* best, const solve_control_s* control, solve_stats_s* stats )
+{
+    if( stats ) memset( stats, 0, sizeof( *stats ) );
+    if( budget == 0 ) return;
+    if( solve_control_s_cancelled( control ) )
+    {
+        if( stats ) stats->cancelled = true;
+        return;
+    }
+
+    progress_s progress;
+    progress_s_begin( &progress, control, budget );
+
+    branch_queue_s queue = { 0 };
+    queue.capacity = budget - 1;
+    uz_t days_run = 0;
+
+    trial_s* trial = trial_s_create();
+    trial_s_reset( trial, o, solver_seed( rseed, 0 ) );
+    trial_s_run_days( trial, o, 0, NULL, &queue, 0, &days_run );
+    trial->cycle = 0;
+    trial_s_copy_state( best, trial );
+    if( control && control->plans ) plan_heap_s_offer( control->plans, o, trial );
+    uz_t runs = 1;
+    if( stats ) stats->days += days_run;
+    progress_s_update( &progress, runs, best->score, false );
+
+    // breadth first: branches at early days are explored first
+    for( ; queue.head < queue.size; runs++ )
+    {
+        if( solve_control_s_cancelled( control ) )
+        {
+            if( stats ) stats->cancelled = true;
+            break;
+        }
+        uz_t day = branch_queue_s_pop( &queue, trial );
+        // ties before day were branched by ancestors, those on day by the parent
+        trial_s_run_days( trial, o, day, NULL, &queue, day + 1, &days_run );
+        trial->cycle = runs;
+        if( stats ) stats->days += days_run;
+        if( trial->score > best->score ) trial_s_copy_state( best, trial );
+        if( control && control->plans ) plan_heap_s_offer( control->plans, o, trial );
+        progress_s_update( &progress, runs + 1, best->score, false );
+    }
+    progress_s_update( &progress, runs, best->score, true );
+    trial_s_discard( trial );
+
+    if( stats )
+    {
+        stats->trials   = runs;
+        stats->distinct = runs;
+    }
+    branch_queue_s_down( &queue );
+}
+
+/**********************************************************************************************************************/
+
+assignment_s* assigner_s_create_assignment_stats( const assigner_s* o, const assignment_s* src, period_s period, const solve_control_s* control, solve_stats_s* stats )
+{
+    if( stats ) memset( stats, 0, sizeof( *stats ) );
+    if( o->cycles == 0 ) return assignment_s_clone( src );
+
+    solver_s* solver = solver_s_create();
+    solver_s_setup( solver, o, src, period );
+
+    trial_s* best_trial = trial_s_create();
+    if( assigner_s_branch_search( o ) )
+    {
+        solver_s_solve_branch( solver, o->rseed, o->cycles, best_trial, control, stats );
+    }
+    else
+    {
+        solver_s_solve_range( solver, o->rseed, 0, o->cycles, best_trial, control, stats );
+    }
+
+    // cancelled before the first trial: nothing assigned
+    bl_t none = ( best_trial->order.size == 0 );
+    assignment_s* best_assignment = none ? assignment_s_clone( src ) : solver_s_create_assignment( solver, src, best_trial );
+
+    trial_s_discard( best_trial );
+    solver_s_discard( solver );
+    return best_assignment;
+}
+
+plan_arr_s* assigner_s_create_plans( const assigner_s* o, const assignment_s* src, period_s period, uz_t k, const solve_control_s* control, solve_stats_s* stats )
+{
+    if( stats ) memset( stats, 0, sizeof( *stats ) );
+    plan_arr_s* plans = plan_arr_s_create();
+    if( k == 0 ) return plans;
+    if( o->cycles == 0 )
+    {
+        bcore_array_a_set_size( ( bcore_array* )plans, 1 );
+        plans->data[ 0 ].assignment = assignment_s_clone( src );
+        return plans;
+    }
+
+    solver_s* solver = solver_s_create();
+    solver_s_setup( solver, o, src, period );
+
+    plan_heap_s heap = { .capacity = k };
+    solve_control_s plan_control = { 0 };
+    if( control ) plan_control = *control;
+    plan_control.plans = &heap;
+
+    trial_s* best_trial = trial_s_create();
+    if( assigner_s_branch_search( o ) )
+    {
+        solver_s_solve_branch( solver, o->rseed, o->cycles, best_trial, &plan_control, stats );
+    }
+    else
+    {
+        solver_s_solve_range( solver, o->rseed, 0, o->cycles, best_trial, &plan_control, stats );
+    }
+
+    plan_heap_s_sort( &heap );
+    bcore_array_a_set_size( ( bcore_array* )plans, heap.size );
+    for( uz_t i = 0; i < heap.size; i++ )
+    {
+        plan_s* plan = &plans->data[ i ];
+        plan->score      = heap.trial[ i ]->score;
+        plan->cycle      = heap.trial[ i ]->cycle;
+        plan->assignment = solver_s_create_assignment( solver, src, heap.trial[ i ] );
+    }
+
+    // cancelled before the first trial: nothing assigned
+    if( plans->size == 0 )
+    {
+        bcore_array_a_set_size( ( bcore_array* )plans, 1 );
+        plans->data[ 0 ].assignment = assignment_s_clone( src );
+    }
+
+    plan_heap_s_down( &heap );
+    trial_s_discard( best_trial );
+    solver_s_discard( solver );
+    return plans;
+}
+
+assignment_s* assigner_s_create_assignment( const assigner_s* o, const assignment_s* src, period_s period )
+{
+    return assigner_s_create_assignment_stats( o, src, period, NULL, NULL );
+}
+
+/// true if sorted array (size) contains value
+static bl_t sorted_uz_contains( const uz_t* data, uz_t size, uz_t value )
+{
+    uz_t lo = 0;
+    uz_t hi = size;
+    while( lo < hi )
+    {
+        uz_t mid = ( lo + hi ) / 2;
+        if( data[ mid ] < value ) lo = mid + 1; else hi = mid;
+    }
+    return lo < size && data[ lo ] == value;
+}
+
+int person_name_cmp( sc_t name1, sc_t name2 )
+{
+    s2_t c = bcore_strcmp( name1, name2 );
+    return ( c > 0 ) ? -1 : ( c < 0 ) ? 1 : 0;
+}
+
+/// orders persons by name (equal names keep their order)
+static int person_ref_cmp_name( const void* a, const void* b )
+{
+    const person_ref_s* ra = a;
+    const person_ref_s* rb = b;
+    int c = person_name_cmp( ra->person->name.sc, rb->person->name.sc );
+    if( c != 0 ) return c;
+    return ( ra->index > rb->index ) - ( ra->index < rb->index );
+}
+
+person_ref_s* assignment_s_create_name_refs( const assignment_s* o )
+{
+    person_ref_s* refs = bcore_malloc( sizeof( person_ref_s ) * ( o->size + 1 ) );
+    for( uz_t i = 0; i < o->size; i++ ) refs[ i ] = ( person_ref_s ){ .person = o->data[ i ], .index = i };
+    qsort( refs, o->size, sizeof( person_ref_s ), person_ref_cmp_name );
+    return refs;
+}
+
+uz_t person_refs_find( const person_ref_s* refs, uz_t size, sc_t name )
+{
+    uz_t lo = 0, hi = size;
+    while( lo < hi )
+    {
+        uz_t mid = lo + ( hi - lo ) / 2;
+        if( person_name_cmp( refs[ mid ].person->name.sc, name ) < 0 ) lo = mid + 1; else hi = mid;
+    }
+    return ( lo < size && person_name_cmp( refs[ lo ].person->name.sc, name ) == 0 ) ? refs[ lo ].index : size;
+}
+
+st_s* assigner_s_evaluate( const assigner_s* o, const assignment_s* base, const assignment_s* result, period_s period, f3_t* objective )
+{
+    f3_t time_start = guard_time_ms();
+    bcore_life_s* l = bcore_life_s_create();
+    solver_s* solver = bcore_life_s_push_aware( l, solver_s_create() );
+    solver_s_setup( solver, o, result, period );
+    model_s* base_model = bcore_life_s_push_aware( l, model_s_create() );
+    model_s_setup( base_model, base );
+
+    const score_function_s* fn = &score_function_arr[ solver->score_function ];
+    const model_s* model = &solver->model;
+    const calendar_s* calendar = &solver->calendar;
+    uz_t persons = model->persons.size;
+    uz_t days    = calendar->cday_arr.size;
+    uz_t base_persons = base_model->persons.size;
+    uz_t period_days  = ( period.last.cday >= period.first.cday ) ? period.last.cday - period.first.cday + 1 : 0;
+
+    // base persons by name
+    person_ref_s* base_refs = assignment_s_create_name_refs( base );
+
+    // active day of each cday in period (days: none)
+    bcore_arr_uz_s* day_of_cday = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s_fill( day_of_cday, period_days, days );
+    for( uz_t j = 0; j < days; j++ ) day_of_cday->data[ calendar->cday_arr.data[ j ] - period.first.cday ] = j;
+
+    bcore_arr_uz_s* day_persons = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s_fill( day_persons, days, 0 );
+    uz_t slots = calendar_s_slots( calendar );
+    f3_t* slot_score = bcore_malloc( sizeof( f3_t ) * ( slots + 1 ) );
+    for( uz_t k = 0; k < slots; k++ ) slot_score[ k ] = 0;
+
+    char buf[ DMY_SIZE ];
+    st_s* st_conflicts = bcore_life_s_push_aware( l, st_s_create() );
+    st_s* st_gaps      = bcore_life_s_push_aware( l, st_s_create() );
+    uz_t conflicts = 0;
+
+    for( uz_t i = 0; i < persons; i++ )
+    {
+        const model_person_s* p = &model->persons.data[ i ];
+        sc_t name = model_s_name( model, i );
+
+        // same person in base (usually same position)
+        uz_t b = base_persons;
+        if( i < base_persons && bcore_strcmp( model_s_name( base_model, i ), name ) == 0 )
+        {
+            b = i;
+        }
+        else
+        {
+            b = person_refs_find( base_refs, base_persons, name );
+        }
+        const uz_t* base_assigned = ( b < base_persons ) ? model_s_assigned( base_model, b ) : NULL;
+        uz_t base_assigned_size   = ( b < base_persons ) ? base_model->persons.data[ b ].assigned_size : 0;
+
+        const uz_t* assigned = model_s_assigned( model, i );
+        uz_t last_cday = 0;
+        uz_t count = 0;
+        uz_t nweekday = p->assigned_nweekday;
+        uz_t gaps = 0, gap_min = 0, gap_max = 0, gap_sum = 0;
+
+        for( uz_t k = 0; k < p->assigned_size; k++ )
+        {
+            uz_t cday = assigned[ k ];
+            if( k > 0 && cday == assigned[ k - 1 ] ) continue;
+            if( cday > period.last.cday ) break;
+            if( cday < period.first.cday )
+            {
+                last_cday = cday;
+                continue;
+            }
+
+            if( last_cday > 0 )
+            {
+                uz_t gap = cday - last_cday;
+                gap_min = ( gaps == 0 || gap < gap_min ) ? gap : gap_min;
+                gap_max = ( gap > gap_max ) ? gap : gap_max;
+                gap_sum += gap;
+                gaps++;
+            }
+
+            uz_t j = day_of_cday->data[ cday - period.first.cday ];
+            if( j == days )
+            {
+                st_s_pushf( st_conflicts, "    %s %s: no active day (weekend, vacation or holiday)\n", dmy_sc_from_cday( buf, cday ), name );
+                conflicts++;
+                last_cday = cday;
+                continue;
+            }
+
+            uz_t wday = wday_from_cday( cday );
+            f3_t score = 1.0;
+            if( !sorted_uz_contains( base_assigned, base_assigned_size, cday ) )
+            {
+                if( model_s_preferences_match( model, i, cday, calendar->wnum_arr.data[ j ] ) <= 0 )
+                {
+                    st_s_pushf( st_conflicts, "    %s %s: preferences do not match\n", dmy_sc_from_cday( buf, cday ), name );
+                    conflicts++;
+                }
+                if( nweekday < 7 && nweekday != wday )
+                {
+                    st_s_pushf( st_conflicts, "    %s %s: weekday differs from %s\n", dmy_sc_from_cday( buf, cday ), name, sc_from_wday( nweekday ) );
+                    conflicts++;
+                }
+
+                score_input_s in;
+                in.x     = ( f3_t )( ( cday > last_cday ) ? ( cday - last_cday ) : 0 ) * p->weight;
+                in.share = ( solver->weight_sum > 0 ) ? p->weight / solver->weight_sum : 0;
+                in.count = count;
+                in.slots = calendar->slot_first_arr.data[ j + 1 ];
+                score = fn->score( o, &in );
+            }
+            if( nweekday >= 7 && p->always_same_workday ) nweekday = wday;
+
+            // on conflicting assignments (more persons than slots) the solver would have chosen the best candidates
+            f3_t* day_score = slot_score + calendar->slot_first_arr.data[ j ];
+            uz_t demand = calendar_s_demand( calendar, j );
+            if( day_persons->data[ j ] < demand )
+            {
+                day_score[ day_persons->data[ j ] ] = score;
+            }
+            else
+            {
+                uz_t min = 0;
+                for( uz_t k = 1; k < demand; k++ ) min = ( day_score[ k ] < day_score[ min ] ) ? k : min;
+                if( score > day_score[ min ] ) day_score[ min ] = score;
+            }
+            day_persons->data[ j ]++;
+            count++;
+            last_cday = cday;
+        }
+
+        st_s_pushf( st_gaps, "    %s: %zu", name, count );
+        if( gaps > 0 ) st_s_pushf( st_gaps, ", gap min %zu, mean %.1f, max %zu", gap_min, ( f3_t )gap_sum / gaps, gap_max );
+        st_s_pushf( st_gaps, "\n" );
+    }
+
+    f3_t score = 0;
+    uz_t fail_count = 0;
+    st_s* st_unfilled = bcore_life_s_push_aware( l, st_s_create() );
+    for( uz_t j = 0; j < days; j++ )
+    {
+        uz_t cday = calendar->cday_arr.data[ j ];
+        uz_t demand = calendar_s_demand( calendar, j );
+        uz_t assigned = day_persons->data[ j ];
+        if( assigned < demand )
+        {
+            st_s_pushf( st_unfilled, "    (W%02zu) %s %s", calendar->wnum_arr.data[ j ], sc_from_wday( wday_from_cday( cday ) ), dmy_sc_from_cday( buf, cday ) );
+            if( demand > 1 ) st_s_pushf( st_unfilled, ": %zu of %zu persons", assigned, demand );
+            st_s_pushf( st_unfilled, "\n" );
+            fail_count += demand - assigned;
+        }
+        if( assigned > demand )
+        {
+            st_s_pushf( st_conflicts, "    %s: %zu persons assigned (%zu required)\n", dmy_sc_from_cday( buf, cday ), assigned, demand );
+            conflicts++;
+        }
+    }
+    for( uz_t k = 0; k < slots; k++ ) score += slot_score[ k ];
+    bcore_free( slot_score );
+    bcore_free( base_refs );
+
+    f3_t value = ( slots > 0 ) ? ( score / slots ) - fail_count : 0;
+    if( objective ) *objective = value;
+
+    st_s* log = st_s_create();
+    char buf_first[ DMY_SIZE ], buf_last[ DMY_SIZE ];
+    st_s_pushf( log, "Period %s - %s (evaluation: %.3f ms)\n", dmy_sc_from_cday( buf_first, period.first.cday ), dmy_sc_from_cday( buf_last, period.last.cday ), guard_time_ms() - time_start );
+    st_s_pushf( log, "Objective: %.6f (%zu active days, %zu unfilled)\n", value, days, fail_count );
+    st_s_pushf( log, "\nUnfilled slots: %zu\n", fail_count );
+    st_s_push_st( log, st_unfilled );
+    st_s_pushf( log, "\nConflicts: %zu\n", conflicts );
+    st_s_push_st( log, st_conflicts );
+    st_s_pushf( log, "\nAssignments and gaps (days) per person:\n" );
+    st_s_push_st( log, st_gaps );
+
+    bcore_life_s_discard( l );
+    return log;
+}
+
+st_s* assigner_s_show_days( const assigner_s* o, const assignment_s* src, period_s period )
+{
+    st_s* log = st_s_create();
+    char buf_first[ DMY_SIZE ], buf_last[ DMY_SIZE ], buf[ DMY_SIZE ];
+    st_s_pushf( log, "Period %s - %s\n", dmy_sc_from_cday( buf_first, period.first.cday ), dmy_sc_from_cday( buf_last, period.last.cday ) );
+
+    bcore_arr_uz_s* day_first = bcore_arr_uz_s_create();
+    bcore_arr_uz_s* day_persons = assignment_s_create_day_persons( src, period.first.cday, period.last.cday, day_first );
+
+    for( uz_t cday = period.first.cday; cday <= period.last.cday; cday++ )
+    {
+        uz_t wday = wday_from_cday( cday );
+        if( wday == 0 ) st_s_pushf( log, "\n" );
+        if( !( &o->mo )[ wday ] ) continue;
+        st_s_pushf( log, "    (W%02zu) %s %s: ", wnum_from_cday( cday ), sc_from_wday( wday ), dmy_sc_from_cday( buf, cday ) );
+        uz_t first = day_first->data[ cday - period.first.cday ];
+        uz_t end   = day_first->data[ cday - period.first.cday + 1 ];
+        if( end > first )
+        {
+            for( uz_t k = first; k < end; k++ ) st_s_pushf( log, ( k > first ) ? ", %s" : "%s", src->data[ day_persons->data[ k ] ]->name.sc );
+            uz_t demand = assigner_s_demand( o, cday );
+            if( assigner_s_free_day( o, cday ) == 0 && end - first < demand ) st_s_pushf( log, " (#### %zu MISSING ####)", demand - ( end - first ) );
+            st_s_pushf( log, "\n" );
+        }
+        else
+        {
+            switch( assigner_s_free_day( o, cday ) )
+            {
+                case 0: st_s_pushf( log, "#### FAILURE ####\n" ); break;
+                case 1: st_s_pushf( log, "VACATION\n" ); break;
+                case 2: st_s_pushf( log, "HOLIDAY\n" ); break;
+                default: break;
+            }
+        }
+    }
+    bcore_arr_uz_s_discard( day_persons );
+    bcore_arr_uz_s_discard( day_first );
+    return log;
+}
+
+/** orders persons like the reflective sort of assignment_s (name, then remaining fields; equal persons keep their order)
+ *  bcore_compare_aware > 0: first object comes first
+ */
+static int person_ref_cmp( const void* a, const void* b )
+{
+    const person_ref_s* ra = a;
+    const person_ref_s* rb = b;
+    s2_t c = bcore_compare_aware( ra->person, rb->person );
+    if( c != 0 ) return ( c > 0 ) ? -1 : 1;
+    return ( ra->index > rb->index ) - ( ra->index < rb->index );
+}
+
+st_s* assigner_s_show_persons( const assigner_s* o, const assignment_s* src )
+{
+    st_s* log = st_s_create();
+    char buf[ DMY_SIZE ];
+
+    // sorts references instead of cloned persons
+    person_ref_s* refs = bcore_malloc( sizeof( person_ref_s ) * ( src->size + 1 ) );
+    for( uz_t i = 0; i < src->size; i++ ) refs[ i ] = ( person_ref_s ){ .person = src->data[ i ], .index = i };
+    qsort( refs, src->size, sizeof( person_ref_s ), person_ref_cmp );
+
+    for( uz_t i = 0; i < src->size; i++ )
+    {
+        const person_s* person = refs[ i ].person;
+        st_s_pushf( log, "%s", person->name.sc );
+        if( person->assigned_nweekday < 7 )
+        {
+            st_s_pushf( log, " (%s)", sc_from_wday( person->assigned_nweekday ) );
+        }
+        st_s_pushf( log, ":", person->name.sc );
+        for( uz_t j = 0; j < person->assigned_dates.size; j++ )
+        {
+            if( j > 0 ) st_s_pushf( log, ", " );
+            if( j % 4 == 0 ) st_s_pushf( log, "\n    " );
+            uz_t cday = person->assigned_dates.data[ j ].cday;
+            st_s_push_sc( log, dmy_sc_from_cday( buf, cday ) );
+        }
+        st_s_pushf( log, "\n\n" );
+    }
+    bcore_free( refs );
+    return log;
+}
+
+typedef struct calendar_row_task_s
+{
+    const assignment_s* assignment;
+    period_s period;
+    uz_t name_space;
+    uz_t cal_start;
+    const st_s* template_row;       // day columns of a row without assignments
+    const bcore_arr_uz_s* day_pos;  // position of each day of the period in template_row
+    char mark_assigned;
+    bcore_arr_st_s* pers_arr;       // receives the row of each person
+} calendar_row_task_s;
+
+static void calendar_row_task( vd_t arg, uz_t index )
+{
+    calendar_row_task_s* o = arg;
+    const person_s* person = o->assignment->data[ index ];
+    st_s* s = o->pers_arr->data[ index ];
+    st_s_push_fa( s, "#pn {#sc_t}", o->name_space, person->name.sc );
+    uz_t awday = person->assigned_nweekday;
+    st_s_push_fa( s, "#pl5 {(#sc_t)}:#pn {}", awday < 7 ? sc_from_wday( awday ) : "**" );
+    st_s_push_fa( s, "#pn {}", o->cal_start - s->size );
+
+    uz_t offset = s->size;
+    st_s_push_st( s, o->template_row );
+    const date_arr_s* a = &person->assigned_dates;
+    for( uz_t j = 0; j < a->size; j++ )
+    {
+        uz_t cday = a->data[ j ].cday;
+        if( !period_s_inside( &o->period, cday ) ) continue;
+        s->data[ offset + o->day_pos->data[ cday - o->period.first.cday ] ] = o->mark_assigned;
+    }
+}
+
+/** Header rows are rendered sequentially together with a template of the day columns.
+ *  Person rows (template with assigned days marked) are rendered concurrently.
+ *  Header, footer, week labels, weekday letters and marks are fragments of layout (NULL: default).
+ */
+st_s* assigner_s_show_calendar( const assigner_s* o, const assignment_s* src, period_s period, const template_s* layout )
+{
+    st_s* log = st_s_create();
+    const assignment_s* assignment = src;
+    if( !layout ) layout = template_default();
+
+   uz_t name_space = 0;
+
+    for( uz_t i = 0; i < assignment->size; i++ )
+    {
+        const person_s* person = assignment->data[ i ];
+        name_space = ( person->name.size > name_space ) ? person->name.size : name_space;
+    }
+
+    char mark_open      = template_s_char( layout, TEMPLATE_CALENDAR_MARKS, 0 );
+    char mark_missing   = template_s_char( layout, TEMPLATE_CALENDAR_MARKS, 1 );
+    char mark_free      = template_s_char( layout, TEMPLATE_CALENDAR_MARKS, 3 );
+    char mark_separator = template_s_char( layout, TEMPLATE_CALENDAR_MARKS, 4 );
+
+    template_values_s values = { { 0 } };
+    values.value[ TEMPLATE_SLOT_FIRST ] = period.first.cday;
+    values.value[ TEMPLATE_SLOT_LAST  ] = period.last.cday;
+
+    bcore_life_s* l = bcore_life_s_create();
+    char buf[ DMY_SIZE ];
+    template_s_render( layout, TEMPLATE_CALENDAR_BEGIN, &values, log );
+
+    uz_t cdays     = ( period.last.cday - period.first.cday + 1 );
+    uz_t gap_width = 7;
+    uz_t cal_start = name_space + gap_width;
+
+    bcore_arr_uz_s* day_first = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_life_s_push_aware( l, assignment_s_create_day_persons( assignment, period.first.cday, period.last.cday, day_first ) );
+
+    st_s* wdat_row = bcore_life_s_push_aware( l, st_s_create() );
     st_s* wnum_row = bcore_life_s_push_aware( l, st_s_create() );
     st_s* wday_row = bcore_life_s_push_aware( l, st_s_create() );
 
@@ -777,15 +2783,9 @@ st_s* assigner_s_show_calendar( const assigner_s* o, const assignment_s* src, pe
     st_s_push_char_n( wnum_row, ' ', cal_start );
     st_s_push_char_n( wday_row, ' ', cal_start );
 
-    bcore_arr_st_s* pers_arr = bcore_life_s_push_aware( l, bcore_arr_st_s_create() );
-    for( uz_t i = 0; i < assignment->size; i++ )
-    {
-        st_s* s = bcore_arr_st_s_push_sc( pers_arr, NULL );
-        st_s_push_fa( s, "#pn {#sc_t}", name_space, assignment->data[ i ]->name.sc );
-        uz_t awday = assignment->data[ i ]->assigned_nweekday;
-        st_s_push_fa( s, "#pl5 {(#sc_t)}:#pn {}", awday < 7 ? sc_from_wday( awday ) : "**" );
-        st_s_push_fa( s, "#pn {}", cal_start - s->size );
-    }
+    st_s* template_row = bcore_life_s_push_aware( l, st_s_create() );
+    bcore_arr_uz_s* day_pos = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s_fill( day_pos, cdays, 0 );
 
     uz_t fail_count = 0;
     for( uz_t i = 0; i < cdays; i++ )
@@ -794,41 +2794,45 @@ st_s* assigner_s_show_calendar( const assigner_s* o, const assignment_s* src, pe
         uz_t wday = wday_from_cday( cday );
         bl_t regular_wday = ( &o->mo )[ wday ];
         s2_t free_type = assigner_s_free_day( o, cday );
-        uz_t assignment_idx = assignment_s_get_assignment_index( assignment, cday );
-        bl_t not_assigned = ( assignment_idx < assignment->size ) ? false : true;
-        bl_t failure = ( regular_wday && ( free_type == 0 ) && not_assigned );
-        fail_count += failure;
+        uz_t assigned = day_first->data[ i + 1 ] - day_first->data[ i ];
+        uz_t demand = ( regular_wday && ( free_type == 0 ) ) ? assigner_s_demand( o, cday ) : 0;
+        bl_t failure = ( assigned < demand );
+        fail_count += failure ? demand - assigned : 0;
 
         if( wday == 0 )
         {
-            st_s* date_st = string_from_cday( cday );
-            uz_t wnum = wnum_from_cday( cday );
-            st_s_push_sc( wday_row, "|" );
-            st_s_push_fa( wnum_row, "|W#uz_t", wnum );
-            st_s_push_fa( wdat_row, "|#t6{#<st_s*>}", date_st );
-            st_s_discard( date_st );
-            for( uz_t i = 0; i < pers_arr->size; i++ ) st_s_push_char( pers_arr->data[ i ], '|' );
+            values.value[ TEMPLATE_SLOT_WEEK ] = wnum_from_cday( cday );
+            st_s_push_char( wday_row, mark_separator );
+            st_s_push_char( wnum_row, mark_separator );
+            template_s_render( layout, TEMPLATE_CALENDAR_WEEK, &values, wnum_row );
+            st_s_push_char( wdat_row, mark_separator );
+            st_s_push_fa( wdat_row, "#t6{#sc_t}", dmy_sc_from_cday( buf, cday ) );
+            st_s_push_char( template_row, mark_separator );
         }
 
-        st_s_push_char( wday_row, week_sc[ wday ] );
+        st_s_push_char( wday_row, template_s_char( layout, TEMPLATE_CALENDAR_WEEKDAYS, wday ) );
 
-        for( uz_t i = 0; i < pers_arr->size; i++ )
-        {
-            bl_t match = date_arr_s_matches( &assignment->data[ i ]->assigned_dates, cday );
-            st_s* s = pers_arr->data[ i ];
-            char c = match ? '!' : ( free_type > 0 ) ? ' ' : regular_wday ? ( failure ? '#' : '-' ) : ' ';
-            st_s_push_char( s, c );
-        }
+        day_pos->data[ i ] = template_row->size;
+        st_s_push_char( template_row, ( free_type > 0 ) ? mark_free : regular_wday ? ( failure ? mark_missing : mark_open ) : mark_free );
 
         if( wday_row->size > wnum_row->size ) st_s_push_char( wnum_row, ' ' );
         if( wday_row->size > wdat_row->size ) st_s_push_char( wdat_row, ' ' );
-        for( uz_t i = 0; i < pers_arr->size; i++ )
-        {
-            st_s* s = pers_arr->data[ i ];
-            if( wday_row->size > s->size ) st_s_push_char( s, ' ' );
-        }
     }
 
+    bcore_arr_st_s* pers_arr = bcore_life_s_push_aware( l, bcore_arr_st_s_create() );
+    for( uz_t i = 0; i < assignment->size; i++ ) bcore_arr_st_s_push_sc( pers_arr, NULL );
+
+    calendar_row_task_s task;
+    task.assignment    = assignment;
+    task.period        = period;
+    task.name_space    = name_space;
+    task.cal_start     = cal_start;
+    task.template_row  = template_row;
+    task.day_pos       = day_pos;
+    task.mark_assigned = template_s_char( layout, TEMPLATE_CALENDAR_MARKS, 2 );
+    task.pers_arr      = pers_arr;
+    guard_parallel_for( assignment->size, calendar_row_task, &task );
+
     st_s* sepr_row = bcore_life_s_push_aware( l, st_s_create_fa( "#rn{-}", wdat_row->size + 1 ) );
 
     st_s_push_fa( log, "#<st_s*>\n", sepr_row );
@@ -838,72 +2842,40 @@ st_s* assigner_s_show_calendar( const assigner_s* o, const assignment_s* src, pe
     st_s_push_fa( log, "#<st_s*>\n", sepr_row );
     for( uz_t i = 0; i < pers_arr->size; i++ ) st_s_push_fa( log, "#<st_s*>\n", pers_arr->data[ i ] );
     st_s_push_fa( log, "#<st_s*>\n", sepr_row );
-    st_s_push_fa( log, "#uz_t missing assignments\n", fail_count );
+    values.value[ TEMPLATE_SLOT_MISSING ] = fail_count;
+    template_s_render( layout, TEMPLATE_CALENDAR_END, &values, log );
 
     bcore_life_s_discard( l );
 
-    assignment_s_discard( assignment );
     return log;
 }
 
 /**********************************************************************************************************************/
 
-st_s* assigner_s_show_html_table( const assigner_s* o, const assignment_s* src, period_s period )
+typedef struct html_week_task_s
 {
-    st_s* log = st_s_create();
-
-    sc_t month_list[] = { "Jan", "Feb", "M&auml;r", "Apr", "Mai", "Jun", "Jul", "Aug", "Sep", "Okt", "Nov", "Dez" };
-
-    st_s_push_fa( log, "<!doctype html>\n" );
-    st_s_push_fa( log, "<html lang=\"de\">\n" );
-    st_s_push_fa( log, "<head>\n" );
-    st_s_push_fa( log, "<meta charset=\"utf-8\">\n" );
-    st_s_push_fa( log, "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n" );
-    st_s_push_fa( log, "<title>Crossing Guard Table</title>\n" );
-
-    st_s_push_fa( log, "<style>\n" );
-
-    st_s_push_fa( log, "table { border-collapse: separate; border-spacing: 0.2em; background-color: ##c0c0c0; }" );
-    st_s_push_fa( log, "td {  text-align: center; background-color: ##ffffff; padding: 0.2em; }" );
-    st_s_push_fa( log, "th {  text-align: center; background-color: ##f0f0f0; padding: 0.5em; }" );
-
-    st_s_push_fa( log, "</style>\n" );
-
-    st_s_push_fa( log, "</head>\n" );
-
-
-    st_s_push_fa( log, "<body>\n" );
-
-    assignment_s* assignment = assignment_s_clone( src );
-
-    bcore_life_s* l = bcore_life_s_create();
-    st_s_push_fa( log, "<h2>#<st_s*> - #<st_s*></h2>\n",
-                  l_string_from_cday( l, period.first.cday ),
-                  l_string_from_cday( l, period.last.cday ) );
-
-    uz_t start_cday = period.first.cday - wday_from_cday( period.first.cday ); // mo of first week
-    uz_t end_cday = period.last.cday - wday_from_cday( period.last.cday ) + 6; // su of last week
-
-    st_s_push_fa( log, "<table>\n" );
-    st_s_push_fa( log, "<thead>\n" );
-    st_s_push_fa( log, "<tr>" );
-    st_s_push_fa( log, "<th> Woche </th>" );
-    if( o->mo ) st_s_push_fa( log, "<th> Montag </th>" );
-    if( o->tu ) st_s_push_fa( log, "<th> Dienstag </th>" );
-    if( o->we ) st_s_push_fa( log, "<th> Mittwoch </th>" );
-    if( o->th ) st_s_push_fa( log, "<th> Donnerstag </th>" );
-    if( o->fr ) st_s_push_fa( log, "<th> Freitag </th>" );
-    if( o->sa ) st_s_push_fa( log, "<th> Samstag </th>" );
-    if( o->su ) st_s_push_fa( log, "<th> Sonntag </th>" );
-    st_s_push_fa( log, "<th></th>" );
-
-    st_s_push_fa( log, "</tr>\n" );
-    st_s_push_fa( log, "</thead>\n" );
-
-    st_s_push_fa( log, "<tbody>\n" );
+    const assigner_s* assigner;
+    const assignment_s* src;
+    const template_s* layout;
+    period_s period;
+    uz_t start_cday;                // monday of first week
+    const bcore_arr_uz_s* day_first;   // see assignment_s_create_day_persons
+    const bcore_arr_uz_s* day_persons;
+    bcore_arr_st_s* week_arr;       // receives the table row of each week
+} html_week_task_s;
+
+/// renders one table row (week); weeks are independent
+static void html_week_task( vd_t arg, uz_t index )
+{
+    html_week_task_s* o = arg;
+    const assigner_s* assigner = o->assigner;
+    const template_s* layout = o->layout;
+    st_s* log = o->week_arr->data[ index ];
+    uz_t first_cday = o->start_cday + index * 7;
     uz_t mnum1 = 0;
     uz_t mnum2 = 0;
-    for( uz_t cday = start_cday; cday <= end_cday; cday++ )
+    template_values_s values = { { 0 } };
+    for( uz_t cday = first_cday; cday < first_cday + 7; cday++ )
     {
         uz_t wday = wday_from_cday( cday );
         dmy_s dmy = dmy_from_cday( cday );
@@ -911,15 +2883,13 @@ st_s* assigner_s_show_html_table( const assigner_s* o, const assignment_s* src,
 
         if( wday == 0 )
         {
-            st_s_push_fa( log, "<tr style=\"background-color: #sc_t;\">", ( wnum & 1 ) ? "#ffffff" : "#f8f8f8" );
-            st_s_push_fa( log, "<td style=\"background-color: #sc_t;\">", "#f0f0f0" );
-            st_s_push_fa( log, "#uz_t", wnum );
-            st_s_push_fa( log, "</td>" );
+            values.value[ TEMPLATE_SLOT_WEEK ] = wnum;
+            template_s_render( layout, ( wnum & 1 ) ? TEMPLATE_HTML_WEEK_ODD : TEMPLATE_HTML_WEEK_EVEN, &values, log );
             mnum1 = 0;
             mnum2 = 0;
         }
 
-        if( ( &o->mo )[ wday ] )
+        if( ( &assigner->mo )[ wday ] )
         {
             if( !mnum1 )
             {
@@ -930,103 +2900,409 @@ st_s* assigner_s_show_html_table( const assigner_s* o, const assignment_s* src,
                 mnum2 = dmy.month;
             }
 
-            uz_t idx = assignment_s_get_assignment_index( src, cday );
-            s2_t free_type = ( idx == src->size ) ? assigner_s_free_day( o, cday ) : 0;
+            uz_t first = o->day_first->data[ cday - o->start_cday ];
+            uz_t end   = o->day_first->data[ cday - o->start_cday + 1 ];
+            s2_t free_type = ( end == first ) ? assigner_s_free_day( assigner, cday ) : 0;
 
-            bl_t regular = idx < src->size;
+            bl_t regular = end > first;
             bl_t vacation = free_type == 1;
             bl_t holiday = free_type == 2;
-            bl_t outside = ( cday < period.first.cday || cday > period.last.cday );
-            bl_t failure = ( !outside ) && ( !regular ) && ( free_type == 0 );
+            bl_t outside = ( cday < o->period.first.cday || cday > o->period.last.cday );
 
-            if( outside )
-            {
-                st_s_push_fa( log, "<td style=\"background-color: #sc_t;\">", "#f0f080" );
-            }
-            else if( regular )
-            {
-                st_s_push_fa( log, "<td>" );
-            }
-            else if( vacation )
-            {
-                st_s_push_fa( log, "<td style=\"background-color: #sc_t;\">", "#f0f0ff" );
-            }
-            else if( holiday )
-            {
-                st_s_push_fa( log, "<td style=\"background-color: #sc_t;\">", "#f0f0ff" );
-            }
-            else if( failure )
-            {
-                st_s_push_fa( log, "<td style=\"background-color: #sc_t;\">", "#f08080" );
-            }
+            uz_t cell = outside  ? TEMPLATE_HTML_CELL_OUTSIDE
+                      : regular  ? TEMPLATE_HTML_CELL_REGULAR
+                      : vacation ? TEMPLATE_HTML_CELL_VACATION
+                      : holiday  ? TEMPLATE_HTML_CELL_HOLIDAY
+                      :            TEMPLATE_HTML_CELL_MISSING;
 
-            st_s_push_fa( log, "#uz_t", dmy.day );
+            values.value[ TEMPLATE_SLOT_DAY ] = dmy.day;
+            template_s_render( layout, cell, &values, log );
 
-            if( idx < src->size )
+            if( regular )
             {
-                person_s* p = src->data[ idx ];
-                st_s_push_fa( log, "<div><b>#sc_t</b></div>", p->name.sc );
+                for( uz_t k = first; k < end; k++ )
+                {
+                    values.name = o->src->data[ o->day_persons->data[ k ] ]->name.sc;
+                    template_s_render( layout, TEMPLATE_HTML_PERSON, &values, log );
+                }
+                bl_t partial = ( !outside ) && assigner_s_free_day( assigner, cday ) == 0 && end - first < assigner_s_demand( assigner, cday );
+                if( partial ) template_s_render( layout, TEMPLATE_HTML_MISSING, NULL, log );
             }
-            else
+            else if( !outside )
             {
-                if( cday >= period.first.cday && cday <= period.last.cday )
+                switch( free_type )
                 {
-                    switch( free_type )
-                    {
-                        case 0: st_s_push_fa( log, "<div style=\"color: ##00ffff; background-color: ##ff0000;\"><b>Fehlt</b></div>" ); break;
-                        case 1: st_s_push_fa( log, "<div>Ferien</div>" ); break;
-                        case 2: st_s_push_fa( log, "<div>Schulfrei</div>" ); break;
-                    }
+                    case 0: template_s_render( layout, TEMPLATE_HTML_MISSING,  NULL, log ); break;
+                    case 1: template_s_render( layout, TEMPLATE_HTML_VACATION, NULL, log ); break;
+                    case 2: template_s_render( layout, TEMPLATE_HTML_HOLIDAY,  NULL, log ); break;
                 }
             }
-            st_s_push_fa( log, "</td>" );
+            template_s_render( layout, TEMPLATE_HTML_CELL_END, NULL, log );
         }
 
         if( wday == 6 )
         {
-            st_s_push_fa( log, "<td style=\"background-color: #sc_t;\">", "#f0f0f0" );
-            if( mnum1 && !mnum2 )
-            {
-                st_s_push_fa( log, "<div>#sc_t</div><div>#uz_t</div>", month_list[ mnum1 - 1 ], dmy.year );
-            }
-            else
-            {
-                if( mnum2 == 1 )
-                {
-                    st_s_push_fa( log, "<div>#sc_t #uz_t/</div><div>#sc_t #uz_t</div>", month_list[ mnum1 - 1 ], dmy.year - 1, month_list[ mnum2 - 1 ], dmy.year );
-                }
-                else
-                {
-                    st_s_push_fa( log, "<div>#sc_t/#sc_t</div><div>#uz_t</div>", month_list[ mnum1 - 1 ], month_list[ mnum2 - 1 ], dmy.year );
-                }
-            }
-
-            st_s_push_fa( log, "</td>" );
+            values.value[ TEMPLATE_SLOT_MONTH1    ] = mnum1;
+            values.value[ TEMPLATE_SLOT_MONTH2    ] = mnum2;
+            values.value[ TEMPLATE_SLOT_YEAR      ] = dmy.year;
+            values.value[ TEMPLATE_SLOT_YEAR_PREV ] = dmy.year - 1;
+            uz_t month = ( mnum1 && !mnum2 ) ? TEMPLATE_HTML_MONTH
+                       : ( mnum2 == 1 )      ? TEMPLATE_HTML_MONTH_YEAR_CHANGE
+                       :                       TEMPLATE_HTML_MONTH_PAIR;
+            template_s_render( layout, month, &values, log );
         }
     }
-    st_s_push_fa( log, "</tbody>\n" );
+}
+
+/// fragments of the layout (NULL: default) are rendered by copying; see template.h
+st_s* assigner_s_show_html_table( const assigner_s* o, const assignment_s* src, period_s period, const template_s* layout )
+{
+    st_s* log = st_s_create();
+    if( !layout ) layout = template_default();
 
-    st_s_push_fa( log, "</table>\n" );
+    bcore_life_s* l = bcore_life_s_create();
+
+    template_values_s values = { { 0 } };
+    values.value[ TEMPLATE_SLOT_FIRST ] = period.first.cday;
+    values.value[ TEMPLATE_SLOT_LAST  ] = period.last.cday;
+    template_s_render( layout, TEMPLATE_HTML_BEGIN, &values, log );
+
+    uz_t start_cday = period.first.cday - wday_from_cday( period.first.cday ); // mo of first week
+    uz_t end_cday = period.last.cday - wday_from_cday( period.last.cday ) + 6; // su of last week
+
+    bcore_arr_uz_s* day_first   = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s* day_persons = bcore_life_s_push_aware( l, assignment_s_create_day_persons( src, start_cday, end_cday, day_first ) );
+
+    for( uz_t wday = 0; wday < 7; wday++ )
+    {
+        if( ( &o->mo )[ wday ] ) template_s_render( layout, TEMPLATE_HTML_HEAD_MO + wday, NULL, log );
+    }
+    template_s_render( layout, TEMPLATE_HTML_HEAD_END, NULL, log );
+
+    bcore_arr_st_s* week_arr = bcore_life_s_push_aware( l, bcore_arr_st_s_create() );
+    uz_t weeks = ( end_cday + 1 - start_cday ) / 7;
+    for( uz_t i = 0; i < weeks; i++ ) bcore_arr_st_s_push_sc( week_arr, NULL );
+
+    html_week_task_s task;
+    task.assigner    = o;
+    task.src         = src;
+    task.layout      = layout;
+    task.period      = period;
+    task.start_cday  = start_cday;
+    task.day_first   = day_first;
+    task.day_persons = day_persons;
+    task.week_arr    = week_arr;
+    guard_parallel_for( weeks, html_week_task, &task );
+    for( uz_t i = 0; i < weeks; i++ ) st_s_push_st( log, week_arr->data[ i ] );
+
+    template_s_render( layout, TEMPLATE_HTML_END, NULL, log );
 
     bcore_life_s_discard( l );
 
-    assignment_s_discard( assignment );
+    return log;
+}
+
+/**********************************************************************************************************************/
+
+st_s* assigner_s_show( const assigner_s* o, const assignment_s* src, period_s period, sc_t format )
+{
+    return assigner_s_show_layout( o, src, period, format, NULL );
+}
+
+st_s* assigner_s_show_layout( const assigner_s* o, const assignment_s* src, period_s period, sc_t format, const template_s* layout )
+{
+    st_s* log = st_s_create();
+    if( bcore_strcmp( format, "dates" ) == 0 )
+    {
+        st_s_push_sc( log, "#### Assignments by date: ####\n\n" );
+        st_s_push_st_d( log, assigner_s_show_days( o, src, period ) );
+    }
+    else if( bcore_strcmp( format, "persons" ) == 0 )
+    {
+        st_s_push_sc( log, "\n#### Assignments by person: ####\n\n" );
+        st_s_push_st_d( log, assigner_s_show_persons( o, src ) );
+    }
+    else if( bcore_strcmp( format, "assignment" ) == 0 )
+    {
+        bcore_txt_ml_a_to_string( src, log );
+    }
+    else if( bcore_strcmp( format, "calendar" ) == 0 )
+    {
+        st_s_push_sc( log, "\n#### Assignment Calendar: ####\n\n" );
+        st_s_push_st_d( log, assigner_s_show_calendar( o, src, period, layout ) );
+    }
+    else if( bcore_strcmp( format, "html_table" ) == 0 )
+    {
+        st_s_push_st_d( log, assigner_s_show_html_table( o, src, period, layout ) );
+    }
+    else if( bcore_strcmp( format, "analysis" ) == 0 )
+    {
+        st_s_push_sc( log, "#### Pre-solve analysis: ####\n\n" );
+        st_s_push_st_d( log, assigner_s_show_analysis( o, src, period ) );
+    }
+    else
+    {
+        st_s_discard( log );
+        return NULL;
+    }
+    return log;
+}
+
+/**********************************************************************************************************************/
+
+st_s* assigner_s_show_analysis( const assigner_s* o, const assignment_s* src, period_s period )
+{
+    st_s* log = st_s_create();
+    bcore_life_s* l = bcore_life_s_create();
+
+    f3_t time_start = guard_time_ms();
+    calendar_s*     calendar     = bcore_life_s_push_aware( l, calendar_s_create() );
+    availability_s* availability = bcore_life_s_push_aware( l, availability_s_create() );
+    model_s*        model        = bcore_life_s_push_aware( l, model_s_create() );
+    model_s_setup( model, src );
+    calendar_s_setup( calendar, o, period );
+    availability_s_setup( availability, calendar, model );
+    f3_t time_setup = guard_time_ms() - time_start;
+
+    char buf_first[ DMY_SIZE ], buf_last[ DMY_SIZE ], buf[ DMY_SIZE ];
+    st_s_pushf( log, "Period %s - %s\n", dmy_sc_from_cday( buf_first, period.first.cday ), dmy_sc_from_cday( buf_last, period.last.cday ) );
+    st_s_pushf( log, "%zu active days, %zu persons (analysis: %.3f ms)\n", calendar->cday_arr.size, src->size, time_setup );
+
+    uz_t days_none = 0;
+    uz_t days_single = 0;
+    for( uz_t j = 0; j < availability->days; j++ )
+    {
+        days_none   += ( availability->candidates.data[ j ] == 0 );
+        days_single += ( availability->candidates.data[ j ] == 1 );
+    }
+
+    st_s_pushf( log, "\nDays without candidate: %zu\n", days_none );
+    for( uz_t j = 0; j < availability->days; j++ )
+    {
+        if( availability->candidates.data[ j ] != 0 ) continue;
+        uz_t cday = calendar->cday_arr.data[ j ];
+        st_s_pushf( log, "    (W%02zu) %s %s\n", calendar->wnum_arr.data[ j ], sc_from_wday( wday_from_cday( cday ) ), dmy_sc_from_cday( buf, cday ) );
+    }
+
+    uz_t days_short = 0;
+    st_s* days_short_list = bcore_life_s_push_aware( l, st_s_create() );
+    for( uz_t j = 0; j < availability->days; j++ )
+    {
+        uz_t candidates = availability->candidates.data[ j ];
+        uz_t demand = calendar_s_demand( calendar, j );
+        if( candidates == 0 || candidates >= demand ) continue;
+        uz_t cday = calendar->cday_arr.data[ j ];
+        st_s_pushf( days_short_list, "    (W%02zu) %s %s: %zu of %zu\n", calendar->wnum_arr.data[ j ], sc_from_wday( wday_from_cday( cday ) ), dmy_sc_from_cday( buf, cday ), candidates, demand );
+        days_short++;
+    }
+    if( days_short > 0 ) st_s_pushf( log, "\nDays with fewer candidates than required persons: %zu\n%s", days_short, days_short_list->sc );
+
+    st_s_pushf( log, "\nDays with a single candidate: %zu\n", days_single );
+    for( uz_t j = 0; j < availability->days; j++ )
+    {
+        if( availability->candidates.data[ j ] != 1 ) continue;
+        uz_t cday = calendar->cday_arr.data[ j ];
+        uz_t idx = availability->day_persons.data[ availability->day_first.data[ j ] ];
+        st_s_pushf( log, "    (W%02zu) %s %s: %s\n", calendar->wnum_arr.data[ j ], sc_from_wday( wday_from_cday( cday ) ), dmy_sc_from_cday( buf, cday ), src->data[ idx ]->name.sc );
+    }
 
+    uz_t persons_none = 0;
+    st_s* persons_none_list = bcore_life_s_push_aware( l, st_s_create() );
+    for( uz_t i = 0; i < availability->persons; i++ )
+    {
+        const uz_t* row = availability->bits.data + i * availability->words;
+        uz_t bits = 0;
+        for( uz_t k = 0; k < availability->words; k++ ) bits |= row[ k ];
+        if( bits ) continue;
+        st_s_pushf( persons_none_list, "    %s\n", src->data[ i ]->name.sc );
+        persons_none++;
+    }
+    st_s_pushf( log, "\nPersons without eligible day: %zu\n%s", persons_none, persons_none_list->sc );
+
+    // coverage histogram per weekday
+    uz_t wday_days[ 7 ] = { 0 };
+    uz_t wday_sum[ 7 ]  = { 0 };
+    uz_t wday_min[ 7 ]  = { 0 };
+    f3_t max_avg = 1;
+    for( uz_t j = 0; j < availability->days; j++ )
+    {
+        uz_t wday = wday_from_cday( calendar->cday_arr.data[ j ] );
+        uz_t candidates = availability->candidates.data[ j ];
+        wday_min[ wday ] = ( wday_days[ wday ] == 0 || candidates < wday_min[ wday ] ) ? candidates : wday_min[ wday ];
+        wday_days[ wday ]++;
+        wday_sum[ wday ] += candidates;
+    }
+    for( uz_t i = 0; i < 7; i++ )
+    {
+        if( wday_days[ i ] == 0 ) continue;
+        f3_t avg = ( f3_t )wday_sum[ i ] / wday_days[ i ];
+        max_avg = ( avg > max_avg ) ? avg : max_avg;
+    }
 
-    st_s_push_fa( log, "<body>\n" );
-    st_s_push_fa( log, "</body>\n" );
-    st_s_push_fa( log, "</html>\n" );
+    st_s_pushf( log, "\nCoverage per weekday (active days, candidates per day: min, avg):\n" );
+    for( uz_t i = 0; i < 7; i++ )
+    {
+        if( wday_days[ i ] == 0 ) continue;
+        f3_t avg = ( f3_t )wday_sum[ i ] / wday_days[ i ];
+        st_s_pushf( log, "    %s: %4zu days, min %4zu, avg %7.1f |", sc_from_wday( i ), wday_days[ i ], wday_min[ i ], avg );
+        st_s_push_char_n( log, '#', ( uz_t )( avg * 40 / max_avg + 0.5 ) );
+        st_s_pushf( log, "\n" );
+    }
 
+    bcore_life_s_discard( l );
     return log;
 }
 
 /**********************************************************************************************************************/
 
+uz_t guard_threads( void )
+{
+    long n = sysconf( _SC_NPROCESSORS_ONLN );
+    return ( n > 0 ) ? n : 1;
+}
+
+typedef struct parallel_for_s
+{
+    uz_t size;
+    uz_t next; // next index (atomic)
+    guard_fp_task fp;
+    vd_t arg;
+} parallel_for_s;
+
+static vd_t parallel_for_worker( vd_t arg )
+{
+    parallel_for_s* o = arg;
+    for( uz_t index = __atomic_fetch_add( &o->next, 1, __ATOMIC_RELAXED ); index < o->size; index = __atomic_fetch_add( &o->next, 1, __ATOMIC_RELAXED ) )
+    {
+        o->fp( o->arg, index );
+    }
+    return NULL;
+}
+
+void guard_parallel_for( uz_t size, guard_fp_task fp, vd_t arg )
+{
+    parallel_for_s o = { .size = size, .next = 0, .fp = fp, .arg = arg };
+    uz_t threads = guard_threads();
+    threads = ( threads > size ) ? size : threads;
+    if( threads <= 1 )
+    {
+        parallel_for_worker( &o );
+        return;
+    }
+
+    pthread_t* thread_arr = bcore_malloc( sizeof( pthread_t ) * threads );
+    for( uz_t i = 1; i < threads; i++ )
+    {
+        if( pthread_create( &thread_arr[ i ], NULL, parallel_for_worker, &o ) ) ERR( "Creating thread failed." );
+    }
+    parallel_for_worker( &o );
+    for( uz_t i = 1; i < threads; i++ ) pthread_join( thread_arr[ i ], NULL );
+    bcore_free( thread_arr );
+}
+
+/**********************************************************************************************************************/
+
+assignment_s* guard_selftest_assignment_create( void )
+{
+    assignment_s* o = assignment_s_create();
+    sc_t names[] = { "A", "B", "C", "D", "E" };
+    for( uz_t i = 0; i < sizeof( names ) / sizeof( sc_t ); i++ )
+    {
+        person_s* p = person_s_create();
+        st_s_copy_sc( &p->name, names[ i ] );
+        bcore_array_a_push( ( bcore_array* )o, sr_asd( p ) );
+    }
+    o->data[ 1 ]->preferences.weight = 0.5;
+    o->data[ 3 ]->preferences.always_same_workday = false;
+    return o;
+}
+
+period_s guard_selftest_period( void )
+{
+    period_s period;
+    period.first.cday = cday_from_dmy_sc( "07.01.2019" );
+    period.last.cday  = cday_from_dmy_sc( "29.03.2019" );
+    return period;
+}
+
+st_s* guard_selftest_temp_file_create( sc_t name )
+{
+    st_s* file = st_s_createf( "/tmp/crossing_guard_%s_XXXXXX", name );
+    int fd = mkstemp( file->data );
+    if( fd < 0 ) ERR( "Cannot create a temporary file." );
+    close( fd );
+    return file;
+}
+
 st_s* guard_selftest( void )
 {
     st_s* log = st_s_create();
     bcore_life_s* l = bcore_life_s_create();
 
+    // persons listing: same order as the reflective sort (duplicate names ordered by their remaining fields)
+    {
+        assignment_s* assignment = bcore_life_s_push_aware( l, assignment_s_create() );
+        sc_t names[] = { "B", "A", "B", "\xc3\x84", "A", "B" };
+        for( uz_t i = 0; i < sizeof( names ) / sizeof( sc_t ); i++ )
+        {
+            person_s* p = person_s_create();
+            st_s_copy_sc( &p->name, names[ i ] );
+            date_arr_s_push_cday( &p->assigned_dates, cday_from_dmy_sc( "07.01.2019" ) + 7 * ( i % 4 ) );
+            bcore_array_a_push( ( bcore_array* )assignment, sr_asd( p ) );
+        }
+        assignment_s* sorted = bcore_life_s_push_aware( l, assignment_s_clone( assignment ) );
+        bcore_array_a_sort( ( bcore_array* )sorted, 0, -1, 1 );
+        st_s* persons1 = bcore_life_s_push_aware( l, assigner_s_show_persons( NULL, assignment ) );
+        st_s* persons2 = bcore_life_s_push_aware( l, assigner_s_show_persons( NULL, sorted ) );
+        ASSERT( st_s_equal_st( persons1, persons2 ) );
+    }
+
+    // branch search: scores of branches equal those of their winners replayed from the start
+    {
+        assigner_s* assigner = bcore_life_s_push_aware( l, assigner_s_create() );
+        st_s_copy_sc( &assigner->search, "branch" );
+        assigner->demand = 2;
+
+        // identical persons tie on each day
+        assignment_s* assignment = bcore_life_s_push_aware( l, assignment_s_create() );
+        for( uz_t i = 0; i < 5; i++ )
+        {
+            person_s* p = person_s_create();
+            st_s_pushf( &p->name, "p%zu", i );
+            bcore_array_a_push( ( bcore_array* )assignment, sr_asd( p ) );
+        }
+
+        period_s period;
+        period.first.cday = cday_from_dmy_sc( "07.01.2019" );
+        period.last.cday  = cday_from_dmy_sc( "01.03.2019" );
+        solver_s* solver = bcore_life_s_push_aware( l, solver_s_create() );
+        solver_s_setup( solver, assigner, assignment, period );
+
+        // each branch of a first trial
+        branch_queue_s queue = { 0 };
+        queue.capacity = 16;
+        trial_s* root = bcore_life_s_push_aware( l, trial_s_create() );
+        trial_s_reset( root, solver, solver_seed( assigner->rseed, 0 ) );
+        trial_s_run_days( root, solver, 0, NULL, &queue, 0, NULL );
+        ASSERT( trial_s_replay_score( root, solver ) == root->score );
+        ASSERT( queue.size > 0 );
+        trial_s* branch = bcore_life_s_push_aware( l, trial_s_create() );
+        while( queue.head < queue.size )
+        {
+            uz_t day = branch_queue_s_pop( &queue, branch );
+            trial_s_run_days( branch, solver, day, NULL, NULL, 0, NULL );
+            ASSERT( trial_s_replay_score( branch, solver ) == branch->score );
+        }
+        branch_queue_s_down( &queue );
+
+        // best plan of the search
+        trial_s* best = bcore_life_s_push_aware( l, trial_s_create() );
+        solve_stats_s stats;
+        solver_s_solve_branch( solver, assigner->rseed, 64, best, NULL, &stats );
+        ASSERT( stats.trials > 1 );
+        ASSERT( trial_s_replay_score( best, solver ) == best->score );
+    }
+
     for( uz_t cday = 0; cday < 60000; cday++ )
     {
         dmy_s* dt = dmy_s_from_cday( cday );
@@ -1035,6 +3311,25 @@ st_s* guard_selftest( void )
         dmy_s_discard( dt );
     }
 
+    for( uz_t cday = 0; cday < 72000; cday++ )
+    {
+        char buf[ DMY_SIZE ];
+        uz_t cday2 = 0;
+        ASSERT( cday_parse_dmy_sc( dmy_sc_from_cday( buf, cday ), &cday2 ) );
+        ASSERT( cday == cday2 );
+    }
+
+    {
+        uz_t cday = 0;
+        ASSERT( !cday_parse_dmy_sc( "29.02.2018", &cday ) );
+        ASSERT( !cday_parse_dmy_sc( "31.04.2018", &cday ) );
+        ASSERT( !cday_parse_dmy_sc( "28.02.1900", &cday ) );
+        ASSERT( !cday_parse_dmy_sc( "01.01.18", &cday ) );
+        ASSERT( !cday_parse_dmy_sc( "01.01.2018x", &cday ) );
+        ASSERT( !cday_parse_dmy_sc( "001.01.2018", &cday ) );
+        ASSERT( cday_parse_dmy_sc( "29.02.2012", &cday ) && cday == cday_from_dmy_sc( "29.02.2012" ) );
+    }
+
     {
         st_s* string = bcore_life_s_push_aware
         (
@@ -1119,6 +3414,8 @@ vd_t guard_signal_handler( const bcore_signal_s* o )
             BCORE_REGISTER_OBJECT( date_arr_s );
             BCORE_REGISTER_OBJECT( period_s );
             BCORE_REGISTER_OBJECT( period_arr_s );
+            BCORE_REGISTER_OBJECT( demand_s );
+            BCORE_REGISTER_OBJECT( demand_arr_s );
             BCORE_REGISTER_OBJECT( weekday_availability_s );
             BCORE_REGISTER_FUNC(  weekday_availability_s_get_weekdays );
             BCORE_REGISTER_FUNC(  weekday_availability_s_set_weekdays );
@@ -1127,7 +3424,16 @@ vd_t guard_signal_handler( const bcore_signal_s* o )
             BCORE_REGISTER_FUNC(  person_s_get_assigned_weekday );
             BCORE_REGISTER_FUNC(  person_s_set_assigned_weekday );
             BCORE_REGISTER_OBJECT( assignment_s );
+            BCORE_REGISTER_OBJECT( plan_s );
+            BCORE_REGISTER_OBJECT( plan_arr_s );
             BCORE_REGISTER_OBJECT( assigner_s );
+            BCORE_REGISTER_OBJECT( model_person_s );
+            BCORE_REGISTER_OBJECT( model_person_arr_s );
+            BCORE_REGISTER_OBJECT( model_s );
+            BCORE_REGISTER_OBJECT( calendar_s );
+            BCORE_REGISTER_OBJECT( availability_s );
+            BCORE_REGISTER_OBJECT( solver_s );
+            BCORE_REGISTER_OBJECT( trial_s );
         }
         break;
 
@@ -13,7 +13,11 @@
  *  limitations under the License.
  */
 
+#ifndef GUARD_H
+#define GUARD_H
+
 #include "bcore_std.h"
+#include "template.h"
 
 /**********************************************************************************************************************/
 // dmy_s
@@ -36,6 +40,15 @@ dmy_s* dmy_s_from_string( const st_s* string );
 dmy_s* dmy_s_from_sc( sc_t sc );
 uz_t   cday_from_dmy_s( const dmy_s* o );
 uz_t   cday_from_dmy_sc( sc_t sc );  // format "07.09.2023"
+
+/// size of a "DD.MM.YYYY" buffer including terminator
+#define DMY_SIZE 11
+
+/// strict "DD.MM.YYYY" parser (no allocation); returns false on invalid format or date
+bl_t cday_parse_dmy_sc( sc_t sc, uz_t* cday );
+
+/// writes "DD.MM.YYYY" into buf (size >= DMY_SIZE); returns buf
+sc_t dmy_sc_from_cday( sd_t buf, uz_t cday );
 dmy_s* dmy_s_from_cday( uz_t cd );
 dmy_s  dmy_from_cday( uz_t cd );
 
@@ -49,6 +62,9 @@ uz_t wday_from_sc( sc_t sc );
 /// wcnt == weekcounter (week 1 starts with first monday on cday)
 uz_t wcnt_from_cday( uz_t cday );
 
+/// cday of the current local date
+uz_t cday_today( void );
+
 /// wnum == weeknumber according to ISO 8601
 uz_t wnum_from_date( const dmy_s* dt );
 uz_t wnum_from_cday( uz_t cday );
@@ -81,6 +97,14 @@ typedef struct date_arr_s
 } date_arr_s;
 BCORE_DECLARE_FUNCTIONS_OBJ( date_arr_s )
 
+bl_t date_arr_s_matches( const date_arr_s* o, uz_t cday );
+
+/// reserves space for at least space dates
+void date_arr_s_reserve( date_arr_s* o, uz_t space );
+
+/// appends cday (typed, no reflective dispatch; space grows geometrically)
+void date_arr_s_push_cday( date_arr_s* o, uz_t cday );
+
 /**********************************************************************************************************************/
 
 #define TYPEOF_period_s typeof( "period_s" )
@@ -114,6 +138,36 @@ BCORE_DECLARE_FUNCTIONS_OBJ( period_arr_s )
 
 /**********************************************************************************************************************/
 
+/// number of persons required on the days of period
+#define TYPEOF_demand_s typeof( "demand_s" )
+typedef struct demand_s
+{
+    aware_t _;
+    period_s period;
+    uz_t count;
+} demand_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( demand_s )
+
+/**********************************************************************************************************************/
+
+#define TYPEOF_demand_arr_s typeof( "demand_arr_s" )
+typedef struct demand_arr_s
+{
+    aware_t _;
+    union
+    {
+        bcore_array_dyn_solid_static_s arr;
+        struct
+        {
+            demand_s* data;
+            uz_t size, space;
+        };
+    };
+} demand_arr_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( demand_arr_s )
+
+/**********************************************************************************************************************/
+
 #define TYPEOF_weekday_availability_s typeof( "weekday_availability_s" )
 typedef struct weekday_availability_s
 {
@@ -170,6 +224,59 @@ typedef struct assignment_s
 } assignment_s;
 BCORE_DECLARE_FUNCTIONS_OBJ( assignment_s )
 
+/// reserves space for at least space person links (typed, no reflective dispatch)
+void assignment_s_reserve( assignment_s* o, uz_t space );
+
+/** Persons assigned to each cday in [first_cday, last_cday] (ascending person index; duplicate dates count once).
+ *  Persons on cday: returned data[ day_first->data[ d ] ... day_first->data[ d + 1 ] - 1 ] with d = cday - first_cday.
+ */
+bcore_arr_uz_s* assignment_s_create_day_persons( const assignment_s* o, uz_t first_cday, uz_t last_cday, bcore_arr_uz_s* day_first );
+
+/// reference to a person of an assignment (sorting references avoids cloning persons)
+typedef struct person_ref_s
+{
+    const person_s* person;
+    uz_t index; // position in the assignment
+} person_ref_s;
+
+/// orders names like the reflective comparison (bcore_strcmp); qsort convention: < 0: name1 comes first
+int person_name_cmp( sc_t name1, sc_t name2 );
+
+/// references to the persons of o sorted by person_name_cmp (equal names keep their order); bcore_free the result
+person_ref_s* assignment_s_create_name_refs( const assignment_s* o );
+
+/// index (in the assignment) of the first person named name in sorted refs of size persons; size if not found
+uz_t person_refs_find( const person_ref_s* refs, uz_t size, sc_t name );
+
+/**********************************************************************************************************************/
+
+/// solution of a solve with its score
+#define TYPEOF_plan_s typeof( "plan_s" )
+typedef struct plan_s
+{
+    aware_t _;
+    f3_t score;
+    uz_t cycle;
+    assignment_s* assignment;
+} plan_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( plan_s )
+
+#define TYPEOF_plan_arr_s typeof( "plan_arr_s" )
+typedef struct plan_arr_s
+{
+    aware_t _;
+    union
+    {
+        bcore_array_dyn_solid_static_s arr;
+        struct
+        {
+            plan_s* data;
+            uz_t size, space;
+        };
+    };
+} plan_arr_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( plan_arr_s )
+
 /**********************************************************************************************************************/
 
 #define TYPEOF_assigner_s typeof( "assigner_s" )
@@ -187,18 +294,337 @@ typedef struct assigner_s
     date_arr_s holidays;
     u2_t rseed;
     uz_t cycles;
+    st_s score_function; // quadratic (default), linear, capped, quota
+    f3_t score_scale;    // linear:  score_scale * dw
+    f3_t score_cap;      // capped:  0.1 * min( dw, score_cap ) / score_cap
+    f3_t quota_weight;   // quota:   quadratic + quota_weight * deficit of assignments relative to weight share
+    bl_t pin_weekdays;   // weekdays of always_same_workday persons are matched before solving (balanced by required persons per weekday)
+    uz_t demand;                   // persons per active day
+    bcore_arr_uz_s weekday_demand; // persons per weekday (mo, tu, ...); overrides demand where specified
+    demand_arr_s demand_arr;       // persons on specific dates; overrides weekday_demand (last match wins)
+    st_s search;                   // random (default): cycles independent trials; branch: branch search with budget cycles
+    bl_t collapse_classes;         // interchangeable persons are solved as classes (least recently assigned member first)
 } assigner_s;
 BCORE_DECLARE_FUNCTIONS_OBJ( assigner_s )
 
 assignment_s* assigner_s_create_assignment( const assigner_s* o, const assignment_s* src, period_s period );
 
+/// true if o selects the branch search (validates search)
+bl_t assigner_s_branch_search( const assigner_s* o );
+
+/// statistics of a solve
+typedef struct solve_stats_s
+{
+    uz_t trials;       // trials run
+    uz_t distinct;     // distinct solutions
+    uz_t duplicates;   // trials aborted because they repeat the tie decisions of an earlier trial
+    uz_t days;         // active days evaluated
+    uz_t days_skipped; // active days saved by aborting duplicates
+    bl_t cancelled;    // stopped early; the result is the best of the trials run
+} solve_stats_s;
+
+/// progress of a solve: done of total trials, best score so far, elapsed time
+typedef void (*guard_fp_progress)( vd_t arg, uz_t done, uz_t total, f3_t best_score, f3_t elapsed_ms );
+
+/// best distinct trials of a solve (see guard.c)
+typedef struct plan_heap_s plan_heap_s;
+
+/// optional control of a solve
+typedef struct solve_control_s
+{
+    const bl_t* cancel;          // checked before each trial; another thread or a signal handler may set it
+    guard_fp_progress progress;  // called at most every progress_ms and when finished
+    vd_t progress_arg;
+    f3_t progress_ms;
+    plan_heap_s* plans;          // receives each completed trial
+} solve_control_s;
+
+/// true if control requests cancellation
+bl_t solve_control_s_cancelled( const solve_control_s* o );
+
+/// rate limited progress reporting (plain struct)
+typedef struct progress_s
+{
+    const solve_control_s* control;
+    uz_t total;
+    f3_t time_start;
+    f3_t time_report;
+} progress_s;
+
+void progress_s_begin( progress_s* o, const solve_control_s* control, uz_t total );
+
+/// reports if progress_ms elapsed since the last report; finished: reports unconditionally
+void progress_s_update( progress_s* o, uz_t done, f3_t best_score, bl_t finished );
+
+/** As assigner_s_create_assignment. control (optional): cancellation and progress; a cancelled solve returns the best
+ *  assignment so far. stats (optional) receives statistics of the solve.
+ */
+assignment_s* assigner_s_create_assignment_stats( const assigner_s* o, const assignment_s* src, period_s period, const solve_control_s* control, solve_stats_s* stats );
+
+/** Solves once and retains the k best distinct plans met during the cycles (plans differ in the persons assigned to
+ *  at least one day). Returns up to k plans with descending score; the first is the result of
+ *  assigner_s_create_assignment_stats. control (control->plans is ignored), stats: see there.
+ */
+plan_arr_s* assigner_s_create_plans( const assigner_s* o, const assignment_s* src, period_s period, uz_t k, const solve_control_s* control, solve_stats_s* stats );
+
+/// number of persons required on cday (regardless of whether cday is an active day)
+uz_t assigner_s_demand( const assigner_s* o, uz_t cday );
+
+/** Evaluates result (e.g. a hand-edited assignment) with the objective of the solver without solving.
+ *  Dates assigned in base count as preassigned. Reports unfilled days, conflicts and gaps per person.
+ *  objective (optional) receives the objective.
+ */
+st_s* assigner_s_evaluate( const assigner_s* o, const assignment_s* base, const assignment_s* result, period_s period, f3_t* objective );
+
 st_s* assigner_s_show_days(       const assigner_s* o, const assignment_s* src, period_s period );
 st_s* assigner_s_show_persons(    const assigner_s* o, const assignment_s* src );
-st_s* assigner_s_show_calendar(   const assigner_s* o, const assignment_s* src, period_s period );
-st_s* assigner_s_show_html_table( const assigner_s* o, const assignment_s* src, period_s period );
+st_s* assigner_s_show_calendar(   const assigner_s* o, const assignment_s* src, period_s period, const template_s* layout );
+st_s* assigner_s_show_html_table( const assigner_s* o, const assignment_s* src, period_s period, const template_s* layout );
+st_s* assigner_s_show_analysis(   const assigner_s* o, const assignment_s* src, period_s period );
+
+/// output in format {dates|persons|assignment|calendar|html_table|analysis}; returns NULL for an unknown format
+st_s* assigner_s_show( const assigner_s* o, const assignment_s* src, period_s period, sc_t format );
+
+/// as assigner_s_show; calendar and html_table are rendered from layout (NULL: built-in default)
+st_s* assigner_s_show_layout( const assigner_s* o, const assignment_s* src, period_s period, sc_t format, const template_s* layout );
+
+/**********************************************************************************************************************/
+// model_s: compact read-only model of an assignment compiled after parsing
+
+/// packed person record; dates and periods are ranges in the pools of model_s
+#define TYPEOF_model_person_s typeof( "model_person_s" )
+typedef struct model_person_s
+{
+    f3_t weight;
+    u2_t name;           // offset of interned name in model_s.names
+    u2_t dates;          // first date in model_s.date_pool: included, excluded, assigned (ascending)
+    u2_t included_size;
+    u2_t excluded_size;
+    u2_t assigned_size;
+    u2_t periods;        // first period in model_s.period_pool (pairs of first, last)
+    u2_t periods_size;
+    u2_t weekly_period;
+    u2_t including_week;
+    u0_t weekday_flags;
+    u0_t assigned_nweekday;
+    bl_t always_same_workday;
+} model_person_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( model_person_s )
+
+#define TYPEOF_model_person_arr_s typeof( "model_person_arr_s" )
+typedef struct model_person_arr_s
+{
+    aware_t _;
+    union
+    {
+        bcore_array_dyn_solid_static_s arr;
+        struct
+        {
+            model_person_s* data;
+            uz_t size, space;
+        };
+    };
+} model_person_arr_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( model_person_arr_s )
+
+#define TYPEOF_model_s typeof( "model_s" )
+typedef struct model_s
+{
+    aware_t _;
+    st_s names;                  // interned names, zero-terminated
+    bcore_arr_uz_s date_pool;    // cdays
+    bcore_arr_uz_s period_pool;  // cdays
+    model_person_arr_s persons;  // same order as the compiled assignment
+} model_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( model_s )
+
+void model_s_setup( model_s* o, const assignment_s* src );
+f3_t model_s_preferences_match( const model_s* o, uz_t person, uz_t cday, uz_t wnum );
+
+static inline sc_t model_s_name( const model_s* o, uz_t person )
+{
+    return o->names.sc + o->persons.data[ person ].name;
+}
+
+/// assigned dates of a person in ascending order
+static inline const uz_t* model_s_assigned( const model_s* o, uz_t person )
+{
+    const model_person_s* p = &o->persons.data[ person ];
+    return o->date_pool.data + p->dates + p->included_size + p->excluded_size;
+}
+
+/**********************************************************************************************************************/
+// calendar_s: active days of a period (regular weekdays outside vacation and holidays)
+
+#define TYPEOF_calendar_s typeof( "calendar_s" )
+typedef struct calendar_s
+{
+    aware_t _;
+    period_s period;
+    bcore_arr_uz_s cday_arr; // active days in ascending order
+    bcore_arr_uz_s wnum_arr; // week number of each active day
+    bcore_arr_uz_s slot_first_arr; // first slot of each active day (size: active days + 1); slots of a day: persons required
+} calendar_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( calendar_s )
+
+void calendar_s_setup( calendar_s* o, const assigner_s* assigner, period_s period );
+
+/// persons required on active day
+static inline uz_t calendar_s_demand( const calendar_s* o, uz_t day )
+{
+    return o->slot_first_arr.data[ day + 1 ] - o->slot_first_arr.data[ day ];
+}
+
+/// total number of slots
+static inline uz_t calendar_s_slots( const calendar_s* o )
+{
+    return o->slot_first_arr.data[ o->cday_arr.size ];
+}
+
+/**********************************************************************************************************************/
+// availability_s: per-person availability bitsets over the active days of a calendar
+
+#define GUARD_WORD_BITS ( sizeof( uz_t ) * 8 )
+
+#define TYPEOF_availability_s typeof( "availability_s" )
+typedef struct availability_s
+{
+    aware_t _;
+    uz_t persons;
+    uz_t days;
+    uz_t words;                // words per person
+    bcore_arr_uz_s bits;       // person-major bitsets: persons x words
+    bcore_arr_uz_s candidates; // number of eligible persons per active day
+    bcore_arr_uz_s day_first;  // first entry in day_persons per active day (size: days + 1)
+    bcore_arr_uz_s day_persons;// eligible persons per active day in ascending order
+} availability_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( availability_s )
+
+void availability_s_setup( availability_s* o, const calendar_s* calendar, const model_s* model );
+
+static inline bl_t availability_s_get( const availability_s* o, uz_t person, uz_t day )
+{
+    return ( o->bits.data[ person * o->words + day / GUARD_WORD_BITS ] >> ( day % GUARD_WORD_BITS ) ) & 1;
+}
+
+/**********************************************************************************************************************/
+// solver_s: precomputed solver input for one assigner, assignment and period
+
+#define TYPEOF_solver_s typeof( "solver_s" )
+typedef struct solver_s
+{
+    aware_t _;
+    assigner_s     assigner;
+    model_s        model;
+    calendar_s     calendar;
+    availability_s availability;
+    uz_t score_function; // index of the selected score function
+    f3_t weight_sum;
+    bcore_arr_uz_s nweekday; // initial weekday per person (7: any); see assigner_s.pin_weekdays
+    bcore_arr_uz_s class_of;        // class per person; each person is a class of its own unless assigner_s.collapse_classes
+    bcore_arr_uz_s class_first;     // first entry in class_members per class (size: classes + 1)
+    bcore_arr_uz_s class_members;   // persons of each class in ascending order
+    bcore_arr_uz_s day_class_first; // first entry in day_classes per active day (size: days + 1)
+    bcore_arr_uz_s day_classes;     // eligible classes per active day in ascending order
+} solver_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( solver_s )
+
+void solver_s_setup( solver_s* o, const assigner_s* assigner, const assignment_s* src, period_s period );
+
+/// recomputes calendar and availability for a different period (model is kept)
+void solver_s_set_period( solver_s* o, period_s period );
+
+/// recomputes model and availability for a different assignment (assigner and calendar are kept)
+void solver_s_set_assignment( solver_s* o, const assignment_s* src );
+
+/**********************************************************************************************************************/
+// trial_s: state and result of one solver trial
+
+#define TYPEOF_trial_s typeof( "trial_s" )
+typedef struct trial_s
+{
+    aware_t _;
+    u2_t rseed;
+    uz_t cycle;               // index in the seed sequence of solver_s_solve
+    f3_t score;
+    uz_t fail_count;
+    bcore_arr_uz_s order;     // order of persons (random permutation)
+    bcore_arr_uz_s rank;      // position of person in order
+    bcore_arr_uz_s last_cday; // last assigned cday before the current day (0: none)
+    bcore_arr_uz_s cursor;    // next assigned date per person in model
+    bcore_arr_uz_s nweekday;  // fixed weekday per person (7: any)
+    bcore_arr_uz_s winner;    // winning person per slot (persons: none); see calendar_s.slot_first_arr
+    bcore_arr_uz_s count;     // assignments per person in this trial
+    bcore_arr_uz_s queue;     // persons of each class, a ring starting at head (layout of solver_s.class_members)
+    bcore_arr_uz_s queue_pos; // position of person in queue
+    bcore_arr_uz_s head;      // front of the queue per class (least recently assigned member)
+    u3_t trajectory;          // hash of the tie decisions (equal for trials with identical results)
+} trial_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( trial_s )
+
+/// typed copy (as trial_s_copy without reflective dispatch; arrays are reused)
+void trial_s_copy_state( trial_s* o, const trial_s* src );
+
+void trial_s_run( trial_s* o, const solver_s* solver, u2_t rseed );
+
+/** runs cycles trials with seeds derived from rseed; best receives the first trial with highest score
+ *  (assigner search "branch": solver_s_solve_branch with budget cycles)
+ */
+void solver_s_solve( const solver_s* o, u2_t rseed, uz_t cycles, trial_s* best );
+
+/** Branch search: Runs the trial of the first seed derived from rseed once and queues a branch for each alternative
+ *  winner at ties (saved state at the start of that day). Branches are run breadth-first from their saved state,
+ *  queuing further branches at later days, until budget runs (including the first) are done.
+ *  best receives the first run with highest score; control, stats (optional): see solver_s_solve_range.
+ */
+void solver_s_solve_branch( const solver_s* o, u2_t rseed, uz_t budget, trial_s* best, const solve_control_s* control, solve_stats_s* stats );
+
+/// seed of trial cycle in the sequence derived from rseed
+u2_t solver_seed( u2_t rseed, uz_t cycle );
+
+/** Runs cycles [first, end) of the sequence of solver_s_solve.
+ *  Trials repeating the tie decisions of an earlier trial are aborted at that point (their result is known).
+ *  control (optional): cancellation and progress. stats (optional): receives statistics.
+ *  Returns false if the range is empty or the run was cancelled (best then holds the best of the trials run, if any).
+ */
+bl_t solver_s_solve_range( const solver_s* o, u2_t rseed, uz_t first, uz_t end, trial_s* best, const solve_control_s* control, solve_stats_s* stats );
+
+/// creates the assignment of a trial from src (persons in trial order)
+assignment_s* solver_s_create_assignment( const solver_s* o, const assignment_s* src, const trial_s* trial );
+
+/**********************************************************************************************************************/
+// parallel execution
+
+typedef void (*guard_fp_task)( vd_t arg, uz_t index );
+
+/// number of worker threads (online processors)
+uz_t guard_threads( void );
+
+/// wall-clock time in milliseconds (monotonic)
+f3_t guard_time_ms( void );
+
+/// FNV-1a hash of a string (stable: history files store it as person key)
+u3_t guard_hash_sc( sc_t sc );
+
+/// calls fp( arg, index ) for each index in [0, size) distributed over worker threads; returns when all calls are done
+void guard_parallel_for( uz_t size, guard_fp_task fp, vd_t arg );
+
+/**********************************************************************************************************************/
+// selftest helpers (shared by the module selftests)
+
+/// five persons A ... E with mixed preferences (B: weight 0.5; D: not always on the same weekday)
+assignment_s* guard_selftest_assignment_create( void );
+
+/// twelve weeks from monday, 07.01.2019
+period_s guard_selftest_period( void );
+
+/// creates an empty temporary file /tmp/crossing_guard_<name>_XXXXXX and returns its path (caller unlinks it)
+st_s* guard_selftest_temp_file_create( sc_t name );
 
 /**********************************************************************************************************************/
 
 vd_t guard_signal_handler( const bcore_signal_s* o );
 
 /**********************************************************************************************************************/
+
+#endif // GUARD_H
@@ -0,0 +1,300 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "history.h"
+
+/**********************************************************************************************************************/
+
+u3_t history_person_key( sc_t name )
+{
+    return guard_hash_sc( name );
+}
+
+static int history_record_cmp( const void* a, const void* b )
+{
+    const history_record_s* ra = a;
+    const history_record_s* rb = b;
+    if( ra->person != rb->person ) return ( ra->person > rb->person ) ? 1 : -1;
+    return ( ra->cday > rb->cday ) - ( ra->cday < rb->cday );
+}
+
+/** Returns a sorted copy of all records (bcore_free the result); *records: number of records.
+ *  The file is read through a private memory mapping. A missing or empty file yields no records.
+ */
+static history_record_s* history_read_sorted( sc_t file, uz_t* records )
+{
+    *records = 0;
+    int fd = open( file, O_RDONLY );
+    if( fd < 0 ) return NULL;
+
+    struct stat st;
+    if( fstat( fd, &st ) != 0 ) ERR( "Cannot access history file '%s'.", file );
+    uz_t size = st.st_size;
+    if( size == 0 )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    uz_t magic_size = bcore_strlen( HISTORY_MAGIC );
+    if( size < magic_size || ( size - magic_size ) % sizeof( history_record_s ) != 0 ) ERR( "'%s' is no valid history file.", file );
+
+    const u0_t* map = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if( map == MAP_FAILED ) ERR( "Cannot map history file '%s'.", file );
+    if( memcmp( map, HISTORY_MAGIC, magic_size ) != 0 ) ERR( "'%s' is no valid history file.", file );
+
+    *records = ( size - magic_size ) / sizeof( history_record_s );
+    history_record_s* data = bcore_malloc( sizeof( history_record_s ) * ( *records + 1 ) );
+    memcpy( data, map + magic_size, sizeof( history_record_s ) * *records );
+    munmap( ( vd_t )map, size );
+
+    qsort( data, *records, sizeof( history_record_s ), history_record_cmp );
+    return data;
+}
+
+static FILE* history_open_append( sc_t file )
+{
+    FILE* f = fopen( file, "ab" );
+    if( !f ) ERR( "Cannot open history file '%s'.", file );
+    fseek( f, 0, SEEK_END );
+    if( ftell( f ) == 0 ) fwrite( HISTORY_MAGIC, 1, bcore_strlen( HISTORY_MAGIC ), f );
+    return f;
+}
+
+static void history_write_record( FILE* f, u3_t person, uz_t cday, uz_t count )
+{
+    history_record_s r;
+    memset( &r, 0, sizeof( r ) );
+    r.person = person;
+    r.cday   = cday;
+    r.count  = count;
+    if( fwrite( &r, sizeof( r ), 1, f ) != 1 ) ERR( "Writing history failed." );
+}
+
+/**********************************************************************************************************************/
+
+static sc_t history_s_def = "history_s = "
+"{"
+    "aware_t _;                      "
+    "period_s period;                "
+    "uz_t window;                    "
+    "uz_t records;                   "
+    "bcore_arr_uz_s person_arr;      "
+    "bcore_arr_uz_s last_cday_arr;   "
+    "bcore_arr_uz_s count_arr;       "
+    "bcore_arr_uz_s count_window_arr;"
+    "bcore_arr_uz_s dates_first_arr; "
+    "bcore_arr_uz_s dates_arr;       "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( history_s, history_s_def )
+
+void history_s_load( history_s* o, sc_t file, period_s period, uz_t window )
+{
+    o->period = period;
+    o->window = window;
+    bcore_arr_uz_s_clear( &o->person_arr );
+    bcore_arr_uz_s_clear( &o->last_cday_arr );
+    bcore_arr_uz_s_clear( &o->count_arr );
+    bcore_arr_uz_s_clear( &o->count_window_arr );
+    bcore_arr_uz_s_clear( &o->dates_first_arr );
+    bcore_arr_uz_s_clear( &o->dates_arr );
+
+    history_record_s* records = history_read_sorted( file, &o->records );
+    uz_t window_first = ( period.first.cday > window ) ? period.first.cday - window : 0;
+
+    for( uz_t i = 0; i < o->records; )
+    {
+        u3_t person = records[ i ].person;
+        uz_t last_cday = 0;
+        uz_t count = 0;
+        uz_t count_window = 0;
+        bcore_arr_uz_s_push( &o->person_arr, person );
+        bcore_arr_uz_s_push( &o->dates_first_arr, o->dates_arr.size );
+        for( ; i < o->records && records[ i ].person == person; i++ )
+        {
+            const history_record_s* r = &records[ i ];
+            uz_t n = ( r->count > 0 ) ? r->count : 1;
+            if( r->cday < period.first.cday )
+            {
+                last_cday = ( r->cday > last_cday ) ? r->cday : last_cday;
+                count += n;
+                if( r->cday >= window_first ) count_window += n; // summaries count at their last day
+            }
+            else if( r->count > 0 )
+            {
+                // the folded dates are unknown; recording the period would add them again
+                char buf[ DMY_SIZE ];
+                ERR( "History '%s': records up to %s are folded; the period must start after that day (compacted too far?).", file, dmy_sc_from_cday( buf, r->cday ) );
+            }
+            else
+            {
+                bcore_arr_uz_s_push( &o->dates_arr, r->cday );
+            }
+        }
+        bcore_arr_uz_s_push( &o->last_cday_arr, last_cday );
+        bcore_arr_uz_s_push( &o->count_arr, count );
+        bcore_arr_uz_s_push( &o->count_window_arr, count_window );
+    }
+    bcore_arr_uz_s_push( &o->dates_first_arr, o->dates_arr.size );
+
+    if( records ) bcore_free( records );
+}
+
+/// index of person in o (o->person_arr.size if not found)
+static uz_t history_s_find( const history_s* o, u3_t person )
+{
+    uz_t lo = 0;
+    uz_t hi = o->person_arr.size;
+    while( lo < hi )
+    {
+        uz_t mid = ( lo + hi ) / 2;
+        if( o->person_arr.data[ mid ] < person ) lo = mid + 1; else hi = mid;
+    }
+    return ( lo < o->person_arr.size && o->person_arr.data[ lo ] == person ) ? lo : o->person_arr.size;
+}
+
+static bl_t history_s_recorded( const history_s* o, uz_t idx, uz_t cday )
+{
+    for( uz_t i = o->dates_first_arr.data[ idx ]; i < o->dates_first_arr.data[ idx + 1 ]; i++ )
+    {
+        if( o->dates_arr.data[ i ] == cday ) return true;
+    }
+    return false;
+}
+
+static void person_s_push_assigned( person_s* p, uz_t cday )
+{
+    if( !date_arr_s_matches( &p->assigned_dates, cday ) ) date_arr_s_push_cday( &p->assigned_dates, cday );
+}
+
+void history_s_apply( const history_s* o, assignment_s* assignment )
+{
+    for( uz_t i = 0; i < assignment->size; i++ )
+    {
+        person_s* p = assignment->data[ i ];
+        uz_t idx = history_s_find( o, history_person_key( p->name.sc ) );
+        if( idx == o->person_arr.size ) continue;
+        if( o->last_cday_arr.data[ idx ] > 0 ) person_s_push_assigned( p, o->last_cday_arr.data[ idx ] );
+        for( uz_t j = o->dates_first_arr.data[ idx ]; j < o->dates_first_arr.data[ idx + 1 ]; j++ )
+        {
+            person_s_push_assigned( p, o->dates_arr.data[ j ] );
+        }
+    }
+}
+
+void history_s_commit( const history_s* o, sc_t file, const assignment_s* assignment, period_s period )
+{
+    FILE* f = history_open_append( file );
+    for( uz_t i = 0; i < assignment->size; i++ )
+    {
+        const person_s* p = assignment->data[ i ];
+        u3_t person = history_person_key( p->name.sc );
+        uz_t idx = o ? history_s_find( o, person ) : 0;
+        bl_t known = o && idx < o->person_arr.size;
+        for( uz_t j = 0; j < p->assigned_dates.size; j++ )
+        {
+            uz_t cday = p->assigned_dates.data[ j ].cday;
+            if( !period_s_inside( &period, cday ) ) continue;
+            if( known && history_s_recorded( o, idx, cday ) ) continue;
+            history_write_record( f, person, cday, 0 );
+        }
+    }
+    fclose( f );
+}
+
+st_s* history_s_show( const history_s* o, const assignment_s* assignment )
+{
+    st_s* log = st_s_create();
+    char buf[ DMY_SIZE ];
+    st_s_pushf( log, "%zu records; summary before %s (window: %zu days)\n\n", o->records, dmy_sc_from_cday( buf, o->period.first.cday ), o->window );
+
+    for( uz_t i = 0; i < assignment->size; i++ )
+    {
+        const person_s* p = assignment->data[ i ];
+        uz_t idx = history_s_find( o, history_person_key( p->name.sc ) );
+        st_s_pushf( log, "%s: ", p->name.sc );
+        if( idx == o->person_arr.size || o->count_arr.data[ idx ] == 0 )
+        {
+            st_s_pushf( log, "no history\n" );
+            continue;
+        }
+        st_s_pushf( log, "last %s, total %zu, window %zu\n", dmy_sc_from_cday( buf, o->last_cday_arr.data[ idx ] ), o->count_arr.data[ idx ], o->count_window_arr.data[ idx ] );
+    }
+    return log;
+}
+
+/**********************************************************************************************************************/
+
+void history_compact( sc_t file, uz_t cutoff_cday )
+{
+    uz_t records = 0;
+    history_record_s* data = history_read_sorted( file, &records );
+
+    st_s* tmp_file = st_s_createf( "%s.tmp", file );
+    FILE* f = fopen( tmp_file->sc, "wb" );
+    if( !f ) ERR( "Cannot create '%s'.", tmp_file->sc );
+    fwrite( HISTORY_MAGIC, 1, bcore_strlen( HISTORY_MAGIC ), f );
+
+    for( uz_t i = 0; i < records; )
+    {
+        u3_t person = data[ i ].person;
+        uz_t last_cday = 0;
+        uz_t count = 0;
+
+        // records are sorted by cday per person: fold the leading part
+        for( ; i < records && data[ i ].person == person && data[ i ].cday < cutoff_cday; i++ )
+        {
+            last_cday = data[ i ].cday;
+            count += ( data[ i ].count > 0 ) ? data[ i ].count : 1;
+        }
+        if( count > 0 ) history_write_record( f, person, last_cday, count );
+
+        for( ; i < records && data[ i ].person == person; i++ )
+        {
+            history_write_record( f, person, data[ i ].cday, data[ i ].count );
+        }
+    }
+
+    fclose( f );
+    if( rename( tmp_file->sc, file ) != 0 ) ERR( "Cannot replace '%s'.", file );
+    st_s_discard( tmp_file );
+    if( data ) bcore_free( data );
+}
+
+/**********************************************************************************************************************/
+
+vd_t history_signal_handler( const bcore_signal_s* o )
+{
+    switch( bcore_signal_s_handle_type( o, typeof( "history" ) ) )
+    {
+        case TYPEOF_init1:
+        {
+            BCORE_REGISTER_OBJECT( history_s );
+        }
+        break;
+
+        default: break;
+    }
+    return NULL;
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,87 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** History Store
+ *  Binary append-only file of past assignments. It replaces long lists of assigned_dates in assignment files.
+ *
+ *  Layout: 8 byte magic followed by fixed size records (native byte order).
+ *  A record either denotes a single assignment or a summary of folded (compacted) assignments.
+ *  Persons are identified by the hash of their name.
+ */
+
+#define HISTORY_MAGIC "CGHIST01"
+
+/// default window (days before period) for history counts
+#define HISTORY_WINDOW 365
+
+typedef struct history_record_s
+{
+    u3_t person; // hash of person name
+    u2_t cday;   // assigned day; summary: last assigned day
+    u2_t count;  // 0: single assignment; > 0: summary of count assignments up to cday
+} history_record_s;
+
+u3_t history_person_key( sc_t name );
+
+/**********************************************************************************************************************/
+// history_s: compact per-person summary of a history file relative to a period
+
+#define TYPEOF_history_s typeof( "history_s" )
+typedef struct history_s
+{
+    aware_t _;
+    period_s period;
+    uz_t window;                    // days before period covered by count_window
+    uz_t records;                   // records in file
+    bcore_arr_uz_s person_arr;      // person keys in ascending order
+    bcore_arr_uz_s last_cday_arr;   // last assigned day before period (0: none)
+    bcore_arr_uz_s count_arr;       // assignments before period
+    bcore_arr_uz_s count_window_arr;// assignments within window before period
+    bcore_arr_uz_s dates_first_arr; // first entry in dates_arr per person (size: persons + 1)
+    bcore_arr_uz_s dates_arr;       // assigned days from period start onward (ascending per person)
+} history_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( history_s )
+
+/** Loads summary of history file (memory mapped); a missing file yields an empty history.
+ *  A summary record on or after the period start is an error: its folded dates cannot be told apart from the period.
+ */
+void history_s_load( history_s* o, sc_t file, period_s period, uz_t window );
+
+/** Adds history to assigned_dates of matching persons: the last assigned day before the period and all assigned days
+ *  from period start onward. The solver's fairness depends only on these dates, hence scores equal those of full lists.
+ */
+void history_s_apply( const history_s* o, assignment_s* assignment );
+
+/// appends assigned days within period not yet recorded in o (o may be NULL)
+void history_s_commit( const history_s* o, sc_t file, const assignment_s* assignment, period_s period );
+
+st_s* history_s_show( const history_s* o, const assignment_s* assignment );
+
+/// folds all records before cutoff_cday into one summary record per person
+void history_compact( sc_t file, uz_t cutoff_cday );
+
+/**********************************************************************************************************************/
+
+vd_t history_signal_handler( const bcore_signal_s* o );
+
+/**********************************************************************************************************************/
+
+#endif // HISTORY_H
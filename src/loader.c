@@ -0,0 +1,228 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <dirent.h>
+#include <glob.h>
+#include <sys/stat.h>
+
+#include "loader.h"
+#include "parser.h"
+
+/**********************************************************************************************************************/
+
+static bl_t path_is_dir( sc_t path )
+{
+    struct stat st;
+    return ( stat( path, &st ) == 0 ) && S_ISDIR( st.st_mode );
+}
+
+static bl_t path_is_file( sc_t path )
+{
+    struct stat st;
+    return ( stat( path, &st ) == 0 ) && S_ISREG( st.st_mode );
+}
+
+static int cmp_st_ptr( const void* a, const void* b )
+{
+    return st_s_cmp_st( *( st_s* const* )a, *( st_s* const* )b );
+}
+
+/// reports an error in err (NULL: terminates)
+static void load_err( st_s* err, sc_t format, sc_t arg )
+{
+    if( !err ) ERR( format, arg );
+    st_s_clear( err );
+    st_s_pushf( err, format, arg );
+}
+
+/// sorted list of files denoted by path; NULL with a message in err when there is none (err NULL: terminates)
+static bcore_arr_st_s* files_from_path( sc_t path, st_s* err )
+{
+    bcore_arr_st_s* files = bcore_arr_st_s_create();
+    if( path_is_dir( path ) )
+    {
+        DIR* dir = opendir( path );
+        if( !dir )
+        {
+            load_err( err, "Cannot open directory '%s'.", path );
+            bcore_arr_st_s_discard( files );
+            return NULL;
+        }
+        for( struct dirent* entry = readdir( dir ); entry; entry = readdir( dir ) )
+        {
+            if( entry->d_name[ 0 ] == '.' ) continue;
+            st_s* file = st_s_createf( "%s/%s", path, entry->d_name );
+            if( path_is_file( file->sc ) ) bcore_arr_st_s_push_st( files, file );
+            st_s_discard( file );
+        }
+        closedir( dir );
+        qsort( files->data, files->size, sizeof( st_s* ), cmp_st_ptr );
+    }
+    else if( path_is_file( path ) )
+    {
+        bcore_arr_st_s_push_sc( files, path );
+    }
+    else
+    {
+        glob_t g;
+        if( glob( path, 0, NULL, &g ) == 0 ) // glob sorts its result
+        {
+            for( uz_t i = 0; i < g.gl_pathc; i++ ) if( path_is_file( g.gl_pathv[ i ] ) ) bcore_arr_st_s_push_sc( files, g.gl_pathv[ i ] );
+        }
+        globfree( &g );
+    }
+
+    if( files->size == 0 )
+    {
+        load_err( err, "No assignment file found at '%s'.", path );
+        bcore_arr_st_s_discard( files );
+        return NULL;
+    }
+    return files;
+}
+
+/**********************************************************************************************************************/
+
+typedef struct load_task_s
+{
+    const bcore_arr_st_s* files;
+    sr_s* results;
+    st_s** errors; // message per file (NULL: terminates on error)
+} load_task_s;
+
+static void load_task( vd_t arg, uz_t index )
+{
+    load_task_s* o = arg;
+    sc_t file = o->files->data[ index ]->sc;
+    o->results[ index ] = o->errors ? parser_try_from_file( file, o->errors[ index ] ) : parser_from_file( file );
+}
+
+typedef struct name_ref_s
+{
+    sc_t name;
+    uz_t file;
+    uz_t index; // position in merged assignment
+} name_ref_s;
+
+static int name_ref_cmp( const void* a, const void* b )
+{
+    const name_ref_s* ra = a;
+    const name_ref_s* rb = b;
+    int c = bcore_strcmp( ra->name, rb->name );
+    if( c != 0 ) return c;
+    return ( ra->index > rb->index ) - ( ra->index < rb->index );
+}
+
+static void report_duplicates( const assignment_s* o, const bcore_arr_st_s* files, const bcore_arr_uz_s* file_of_person )
+{
+    if( o->size == 0 ) return;
+    name_ref_s* refs = bcore_malloc( sizeof( name_ref_s ) * o->size );
+    for( uz_t i = 0; i < o->size; i++ )
+    {
+        refs[ i ].name  = o->data[ i ]->name.sc;
+        refs[ i ].file  = file_of_person->data[ i ];
+        refs[ i ].index = i;
+    }
+    qsort( refs, o->size, sizeof( name_ref_s ), name_ref_cmp );
+    for( uz_t i = 1; i < o->size; i++ )
+    {
+        if( bcore_strcmp( refs[ i - 1 ].name, refs[ i ].name ) != 0 ) continue;
+        bcore_err_fa( "Warning: Duplicate name '#sc_t' in '#sc_t' and '#sc_t'.\n", refs[ i ].name, files->data[ refs[ i - 1 ].file ]->sc, files->data[ refs[ i ].file ]->sc );
+    }
+    bcore_free( refs );
+}
+
+/// loads path; returns NULL with a message in err on error (err NULL: terminates)
+static assignment_s* assignment_s_load( sc_t path, st_s* err )
+{
+    bcore_arr_st_s* files = files_from_path( path, err );
+    if( !files ) return NULL;
+    sr_s* results = bcore_malloc( sizeof( sr_s ) * files->size );
+    st_s** errors = err ? bcore_malloc( sizeof( st_s* ) * files->size ) : NULL;
+    for( uz_t i = 0; i < files->size; i++ ) results[ i ] = sr_null();
+    for( uz_t i = 0; errors && i < files->size; i++ ) errors[ i ] = st_s_create();
+
+    load_task_s task = { .files = files, .results = results, .errors = errors };
+    guard_parallel_for( files->size, load_task, &task );
+
+    // first failing file in order
+    uz_t failed = files->size;
+    uz_t persons = 0;
+    for( uz_t i = 0; i < files->size && failed == files->size; i++ )
+    {
+        if( errors && errors[ i ]->size > 0 )
+        {
+            st_s_clear( err );
+            st_s_push_st( err, errors[ i ] );
+            failed = i;
+        }
+        else if( sr_s_type( &results[ i ] ) != TYPEOF_assignment_s )
+        {
+            load_err( err, "Incorrect file '%s'. <assignment_s> expected.", files->data[ i ]->sc );
+            failed = i;
+        }
+        else
+        {
+            persons += ( ( assignment_s* )results[ i ].o )->size;
+        }
+    }
+
+    for( uz_t i = 0; errors && i < files->size; i++ ) st_s_discard( errors[ i ] );
+    if( errors ) bcore_free( errors );
+
+    if( failed < files->size )
+    {
+        for( uz_t i = 0; i < files->size; i++ ) sr_down( results[ i ] );
+        bcore_free( results );
+        bcore_arr_st_s_discard( files );
+        return NULL;
+    }
+
+    assignment_s* o = assignment_s_create();
+    bcore_arr_uz_s* file_of_person = bcore_arr_uz_s_create();
+    assignment_s_reserve( o, persons );
+    for( uz_t i = 0; i < files->size; i++ )
+    {
+        // move person links; the emptied source no longer owns them
+        assignment_s* a = results[ i ].o;
+        for( uz_t j = 0; j < a->size; j++ )
+        {
+            o->data[ o->size++ ] = a->data[ j ];
+            bcore_arr_uz_s_push( file_of_person, i );
+        }
+        a->size = 0;
+        sr_down( results[ i ] );
+    }
+
+    report_duplicates( o, files, file_of_person );
+
+    bcore_arr_uz_s_discard( file_of_person );
+    bcore_free( results );
+    bcore_arr_st_s_discard( files );
+    return o;
+}
+
+assignment_s* assignment_s_create_from_path( sc_t path )
+{
+    return assignment_s_load( path, NULL );
+}
+
+assignment_s* assignment_s_try_create_from_path( sc_t path, st_s* err )
+{
+    return assignment_s_load( path, err );
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,36 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Loading of assignment_s from multiple files
+ *  A path is either a file, a directory (all regular files not starting with '.') or a glob pattern.
+ *  Files are parsed concurrently and merged in ascending order of file names. Persons keep their order within a file.
+ *  Duplicate names are reported on stderr.
+ */
+
+assignment_s* assignment_s_create_from_path( sc_t path );
+
+/// as above but returns NULL with the message in err instead of terminating on a missing or malformed file
+assignment_s* assignment_s_try_create_from_path( sc_t path, st_s* err );
+
+/**********************************************************************************************************************/
+
+#endif // LOADER_H
@@ -13,8 +13,73 @@
  *  limitations under the License.
  */
 
+#include <signal.h>
+
 #include "bcore_std.h"
 #include "guard.h"
+#include "history.h"
+#include "loader.h"
+#include "parser.h"
+#include "context.h"
+#include "shard.h"
+#include "export.h"
+#include "watch.h"
+#include "sweep.h"
+#include "checkpoint.h"
+
+/// command line options following the mandatory arguments
+typedef struct options_s
+{
+    st_s* output_format;
+    st_s* output_file;
+    st_s* history_file;   // binary history store
+    bl_t  history_commit; // appends the result to the history store
+    uz_t  shard;          // shard index (0 <= shard < shards)
+    uz_t  shards;         // > 0: solves only a slice of cycles and outputs a shard result
+    const bcore_arr_st_s* merge_files; // shard results to merge instead of solving
+    st_s* evaluate_file;  // assignment to be evaluated instead of solving
+    bl_t  watch;          // solves again whenever an input file changes
+    st_s* checkpoint_file; // saves the progress of the solve periodically
+    bl_t  resume;         // continues from checkpoint_file if it exists
+    bl_t  stats;          // reports solver statistics (stderr)
+    bl_t  progress;       // reports the progress of the solve (stderr)
+    uz_t  alternatives;   // > 1: outputs the best distinct plans of the solve
+    const template_s* layout; // layout of calendar and html_table (NULL: built-in)
+    st_s* baseline_file;  // previously published result; output is the change set (format delta, delta_jsonl)
+} options_s;
+
+/// exit code when the solve was stopped by a signal (output holds the best plan so far)
+#define EXIT_STOPPED 3
+
+/// minimum time between two progress reports
+#define PROGRESS_INTERVAL_MS 1000
+
+static bl_t solve_cancel  = false; // set by SIGINT or SIGTERM (atomic)
+static bl_t solve_stopped = false; // the solve was cancelled
+
+static void on_stop_signal( int sig )
+{
+    __atomic_store_n( &solve_cancel, true, __ATOMIC_RELAXED );
+}
+
+/// first SIGINT or SIGTERM stops the solve; the handler resets itself so that a second signal terminates
+static void install_stop_handlers( void )
+{
+    struct sigaction action;
+    memset( &action, 0, sizeof( action ) );
+    action.sa_handler = on_stop_signal;
+    action.sa_flags   = SA_RESETHAND;
+    sigemptyset( &action.sa_mask );
+    sigaction( SIGINT,  &action, NULL );
+    sigaction( SIGTERM, &action, NULL );
+}
+
+static void progress_print( vd_t arg, uz_t done, uz_t total, f3_t best_score, f3_t elapsed_ms )
+{
+    f3_t rate = ( elapsed_ms > 0 ) ? done * 1000.0 / elapsed_ms : 0;
+    f3_t eta  = ( rate > 0 ) ? ( total - done ) / rate : 0;
+    fprintf( stderr, "%zu/%zu cycles, best score %.6f, %.1f cycles/s, ETA %.0f s\n", done, total, best_score, rate, eta );
+}
 
 void selftest()
 {
@@ -27,51 +92,145 @@ void selftest()
     bcore_txt_ml_x_to_stdout( bcore_inst_t_create_sr( typeof( "assigner_s" ) ) );
 }
 
-st_s* process( const st_s* assigner_file, const st_s* assignment_file, period_s period, const st_s* output_format )
+/// renders assignment in output_format (layout: see options_s)
+static st_s* render( const assigner_s* assigner, const assignment_s* assignment, period_s period, sc_t output_format, const template_s* layout )
+{
+    st_s* out = assigner_s_show_layout( assigner, assignment, period, output_format, layout );
+    if( !out ) out = assigner_s_export( assigner, assignment, period, output_format );
+    if( !out ) ERR( "Unknown output format '%s' (choose from {dates|persons|assignment|calendar|html_table|analysis|history|csv|csv_days|jsonl|jsonl_days|bin}", output_format );
+    return out;
+}
+
+st_s* process( const st_s* assigner_file, const st_s* assignment_file, period_s period, const options_s* options )
 {
+    sc_t output_format = options->output_format ? options->output_format->sc : "";
     st_s* log = st_s_create();
     bcore_life_s* l = bcore_life_s_create();
-    sr_s assigner_sr = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( assigner_file->sc ) );
+    sr_s assigner_sr = bcore_life_s_push_sr( l, parser_from_file( assigner_file->sc ) );
     if( sr_s_type( &assigner_sr ) != typeof( "assigner_s" ) )
     {
         ERR( "Incorrect file '%s'. <assigner_s> expected.", assigner_file );
     }
 
-    sr_s assignment_sr = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( assignment_file->sc ) );
-    if( sr_s_type( &assignment_sr ) != typeof( "assignment_s" ) )
+    // assignment_file can also be a directory or glob pattern of multiple assignment files
+    assignment_s* assignment = bcore_life_s_push_aware( l, assignment_s_create_from_path( assignment_file->sc ) );
+
+    history_s* history = NULL;
+    if( options->history_file )
     {
-        ERR( "Incorrect file '%s'. <assignment_s> expected.", assignment_sr );
+        history = bcore_life_s_push_aware( l, history_s_create() );
+        history_s_load( history, options->history_file->sc, period, HISTORY_WINDOW );
+        history_s_apply( history, assignment );
     }
 
-    assignment_s* final_assignment = assigner_s_create_assignment( assigner_sr.o, assignment_sr.o, period );
-    bcore_life_s_push_aware( l, final_assignment );
+    // loaded before solving so that an invalid baseline fails early
+    assignment_s* baseline = NULL;
+    if( options->baseline_file ) baseline = bcore_life_s_push_aware( l, assignment_s_create_from_path( options->baseline_file->sc ) );
+
+    if( bcore_strcmp( output_format, "analysis" ) == 0 )
+    {
+        st_s_push_st_d( log, assigner_s_show( assigner_sr.o, assignment, period, output_format ) );
+        bcore_life_s_discard( l );
+        return log;
+    }
+
+    if( bcore_strcmp( output_format, "history" ) == 0 )
+    {
+        if( !history ) ERR( "Format 'history' requires option -history." );
+        st_s_push_sc( log, "#### History: ####\n\n" );
+        st_s_push_st_d( log, history_s_show( history, assignment ) );
+        bcore_life_s_discard( l );
+        return log;
+    }
 
-    if( st_s_equal_sc( output_format, "dates" ) )
+    if( options->evaluate_file )
     {
-        st_s_push_sc( log, "#### Assignments by date: ####\n\n" );
-        st_s_push_st_d( log, assigner_s_show_days( assigner_sr.o, final_assignment, period ) );
+        assignment_s* result = bcore_life_s_push_aware( l, assignment_s_create_from_path( options->evaluate_file->sc ) );
+        if( history ) history_s_apply( history, result );
+        st_s_push_st_d( log, assigner_s_evaluate( assigner_sr.o, assignment, result, period, NULL ) );
+        bcore_life_s_discard( l );
+        return log;
     }
-    else if( st_s_equal_sc( output_format, "persons" ) )
+
+    if( options->shards > 0 )
     {
-        st_s_push_sc( log, "\n#### Assignments by person: ####\n\n" );
-        st_s_push_st_d( log, assigner_s_show_persons( assigner_sr.o, final_assignment ) );
+        if( options->history_commit ) ERR( "Option -commit cannot be combined with -shard." );
+        shard_result_s* result = bcore_life_s_push_aware( l, shard_result_s_create_solved( assigner_sr.o, assignment, period, options->shard, options->shards ) );
+        bcore_txt_ml_a_to_string( result, log );
+        bcore_life_s_discard( l );
+        return log;
     }
-    else if( st_s_equal_sc( output_format, "assignment" ) )
+
+    solve_control_s control = { .cancel = &solve_cancel };
+    if( options->progress )
     {
-        bcore_txt_ml_x_to_stdout( sr_awc( final_assignment ) );
+        control.progress    = progress_print;
+        control.progress_ms = PROGRESS_INTERVAL_MS;
     }
-    else if( st_s_equal_sc( output_format, "calendar" ) )
+
+    assignment_s* final_assignment = NULL;
+    plan_arr_s* plans = NULL; // -alternatives: final_assignment is the first plan
+    if( options->merge_files )
     {
-        st_s_push_sc( log, "\n#### Assignment Calendar: ####\n\n" );
-        st_s_push_st_d( log, assigner_s_show_calendar( assigner_sr.o, final_assignment, period ) );
+        final_assignment = shard_merge( assigner_sr.o, assignment, period, options->merge_files );
     }
-    else if( st_s_equal_sc( output_format, "html_table" ) )
+    else if( options->checkpoint_file )
     {
-        st_s_push_st_d( log, assigner_s_show_html_table( assigner_sr.o, final_assignment, period ) );
+        final_assignment = checkpoint_solve( assigner_sr.o, assignment, period, options->checkpoint_file->sc, options->resume, &control, &solve_stopped );
     }
     else
     {
-        ERR( "Unknown output format '%s' (choose from {dates|persons|assignment|calendar|html_table}", output_format );
+        solve_stats_s stats;
+        if( options->alternatives > 1 )
+        {
+            plans = bcore_life_s_push_aware( l, assigner_s_create_plans( assigner_sr.o, assignment, period, options->alternatives, &control, &stats ) );
+            final_assignment = assignment_s_clone( plans->data[ 0 ].assignment );
+        }
+        else
+        {
+            final_assignment = assigner_s_create_assignment_stats( assigner_sr.o, assignment, period, &control, &stats );
+        }
+        solve_stopped = stats.cancelled;
+        if( options->stats )
+        {
+            fprintf( stderr, "%zu trials, %zu distinct solutions, %zu duplicates aborted early (%zu of %zu active days skipped)\n",
+                     stats.trials, stats.distinct, stats.duplicates, stats.days_skipped, stats.days + stats.days_skipped );
+        }
+    }
+    bcore_life_s_push_aware( l, final_assignment );
+    if( solve_stopped ) fprintf( stderr, "Solve stopped; output is the best plan so far.\n" );
+
+    if( options->history_commit )
+    {
+        if( !history ) ERR( "Option -commit requires option -history." );
+
+        // the history is append-only: a partial plan would skew fairness of all later periods
+        if( solve_stopped )
+        {
+            fprintf( stderr, "History '%s' not updated (solve stopped).\n", options->history_file->sc );
+        }
+        else
+        {
+            history_s_commit( history, options->history_file->sc, final_assignment, period );
+        }
+    }
+
+    if( baseline )
+    {
+        st_s_push_st_d( log, assignment_s_export_delta( final_assignment, baseline, period, output_format ) );
+    }
+    else if( plans )
+    {
+        for( uz_t i = 0; i < plans->size; i++ )
+        {
+            st_s_pushf( log, "#### Plan %zu of %zu (score %.6f) ####\n\n", i + 1, plans->size, plans->data[ i ].score );
+            st_s_push_st_d( log, render( assigner_sr.o, plans->data[ i ].assignment, period, output_format, options->layout ) );
+            st_s_push_sc( log, "\n" );
+        }
+    }
+    else
+    {
+        st_s_push_st_d( log, render( assigner_sr.o, final_assignment, period, output_format, options->layout ) );
     }
 
     bcore_life_s_discard( l );
@@ -79,63 +238,308 @@ st_s* process( const st_s* assigner_file, const st_s* assignment_file, period_s
     return log;
 }
 
-int main( int argc, const char** argv )
+/// cday of the same day of month the given number of months earlier (clamped to month end)
+uz_t cday_months_before( uz_t cday, uz_t months )
 {
-    bcore_register_signal_handler( guard_signal_handler );
+    dmy_s dt = dmy_from_cday( cday );
+    uz_t mcount = dt.year * 12 + dt.month - 1 - months;
+    dt.year  = mcount / 12;
+    dt.month = mcount % 12 + 1;
+    uz_t mdays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uz_t max_day = mdays[ dt.month - 1 ] + ( ( dt.month == 2 && dt.year % 4 == 0 ) ? 1 : 0 );
+    dt.day = ( dt.day > max_day ) ? max_day : dt.day;
+    return cday_from_dmy_s( &dt );
+}
 
-    if( argc < 5 )
+/** Solves and renders; argv[ 1 ] ... argv[ 4 ]: config, assignment, start date, end date; options start at first_option.
+ *  merge_files: shard results to merge instead of solving (NULL: solve)
+ */
+static void run( int argc, const char** argv, uz_t first_option, const bcore_arr_st_s* merge_files )
+{
+    bcore_life_s* l = bcore_life_s_create();
+    st_s* config_file     = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 1 ] ) );
+    st_s* assignment_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 2 ] ) );
+    st_s* first_date      = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 3 ] ) );
+    st_s* last_date       = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 4 ] ) );
+    period_s period;
+    period.first.cday = cday_from_dmy_sc( first_date->sc );
+    period.last.cday  = cday_from_dmy_sc( last_date->sc );
+
+    options_s options = { 0 };
+    options.merge_files = merge_files;
+    for( uz_t i = first_option; i < argc; i++ )
     {
-        bcore_msg( "Crossing Guard - Copyright (C) 2017, 2018 Johannes B. Steffens\n" );
-        bcore_msg( "Insufficient input.\n" );
-        bcore_msg( "Usage:\n" );
-        bcore_msg( "   crossing_guard <config_file> <assignment_file> <start_date> <end_date> [-format {dates|persons|assignment|calendar|html_table} ]\n" );
-        bcore_msg( "Example: crossing_guard config.txt assignment.txt 01.01.2018 31.03.2018 -format persons\n" );
+        if( bcore_strcmp( argv[ i ], "-format" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.output_format = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-file" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.output_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-history" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.history_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-commit" ) == 0 )
+        {
+            options.history_commit = true;
+        }
+        else if( bcore_strcmp( argv[ i ], "-watch" ) == 0 )
+        {
+            options.watch = true;
+        }
+        else if( bcore_strcmp( argv[ i ], "-evaluate" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.evaluate_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-checkpoint" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.checkpoint_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-resume" ) == 0 )
+        {
+            options.resume = true;
+        }
+        else if( bcore_strcmp( argv[ i ], "-stats" ) == 0 )
+        {
+            options.stats = true;
+        }
+        else if( bcore_strcmp( argv[ i ], "-progress" ) == 0 )
+        {
+            options.progress = true;
+        }
+        else if( bcore_strcmp( argv[ i ], "-alternatives" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.alternatives = atoi( argv[ i ] );
+            if( options.alternatives == 0 ) ERR( "Invalid number of alternatives '%s'.", argv[ i ] );
+        }
+        else if( bcore_strcmp( argv[ i ], "-baseline" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.baseline_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-template" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            options.layout = bcore_life_s_push_aware( l, template_s_create_from_file( argv[ i ] ) );
+        }
+        else if( bcore_strcmp( argv[ i ], "-shard" ) == 0 )
+        {
+            if( ++i == argc ) break;
+            if( sscanf( argv[ i ], "%zu/%zu", &options.shard, &options.shards ) != 2 ) ERR( "Invalid shard '%s' (expected k/n).", argv[ i ] );
+            if( merge_files ) ERR( "Option -shard cannot be used with merge." );
+        }
+        else
+        {
+            ERR( "Invalid Argument '%s'", argv[ i ] );
+        }
+    }
+
+    if( options.resume && !options.checkpoint_file ) ERR( "Option -resume requires option -checkpoint." );
+    if( options.checkpoint_file && ( options.shards || merge_files || options.evaluate_file || options.watch ) )
+    {
+        ERR( "Option -checkpoint cannot be combined with -shard, -evaluate, -watch or merge." );
+    }
+
+    if( options.layout && options.watch ) ERR( "Option -template cannot be combined with -watch." );
+
+    bl_t delta_format = options.output_format && ( st_s_equal_sc( options.output_format, "delta" ) || st_s_equal_sc( options.output_format, "delta_jsonl" ) );
+    if( delta_format && !options.baseline_file ) ERR( "Format '%s' requires option -baseline.", options.output_format->sc );
+    if( options.baseline_file )
+    {
+        if( !delta_format ) ERR( "Option -baseline requires format delta or delta_jsonl." );
+        if( options.shards || options.evaluate_file || options.watch || options.alternatives > 1 )
+        {
+            ERR( "Option -baseline cannot be combined with -shard, -evaluate, -watch or -alternatives." );
+        }
+    }
+
+    if( options.alternatives > 1 )
+    {
+        if( options.shards || merge_files || options.evaluate_file || options.watch || options.checkpoint_file )
+        {
+            ERR( "Option -alternatives cannot be combined with -shard, -evaluate, -watch, -checkpoint or merge." );
+        }
+        if( options.output_format && st_s_equal_sc( options.output_format, "bin" ) ) ERR( "Format 'bin' holds a single plan; it cannot be combined with -alternatives." );
+    }
+
+    if( options.watch )
+    {
+        if( options.history_file || options.evaluate_file || options.shards || merge_files ) ERR( "Option -watch cannot be combined with -history, -evaluate, -shard or merge." );
+        if( !options.output_format ) ERR( "Option -watch requires option -format." );
+        guard_watch( config_file->sc, assignment_file->sc, period, options.output_format->sc, options.output_file ? options.output_file->sc : NULL );
+        bcore_life_s_discard( l );
+        return;
+    }
+
+    install_stop_handlers();
+    st_s* out = bcore_life_s_push_aware( l, process( config_file, assignment_file, period, &options ) );
+    if( options.output_file )
+    {
+        vd_t file = bcore_life_s_push_aware( l, bcore_sink_open_file( options.output_file->sc ) );
+        bcore_sink_a_push_string( file, out );
     }
     else
     {
-        bcore_life_s* l = bcore_life_s_create();
-        st_s* config_file     = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 1 ] ) );
-        st_s* assignment_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 2 ] ) );
-        st_s* first_date      = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 3 ] ) );
-        st_s* last_date       = bcore_life_s_push_aware( l, st_s_create_sc( argv[ 4 ] ) );
-        period_s period;
-        period.first.cday = cday_from_dmy_sc( first_date->sc );
-        period.last.cday  = cday_from_dmy_sc( last_date->sc );
-
-        st_s* output_format = NULL;
-        st_s* output_file = NULL;
-        for( uz_t i = 5; i < argc; i++ )
-        {
-            if( bcore_strcmp( argv[ i ], "-format" ) == 0 )
-            {
-                if( ++i == argc ) break;
-                output_format = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
-            }
-            else if( bcore_strcmp( argv[ i ], "-file" ) == 0 )
-            {
-                if( ++i == argc ) break;
-                output_file = bcore_life_s_push_aware( l, st_s_create_sc( argv[ i ] ) );
-            }
-            else
-            {
-                ERR( "Invalid Argument '%s'", argv[ i ] );
-            }
-        }
-
-        st_s* out = bcore_life_s_push_aware( l, process( config_file, assignment_file, period, output_format ) );
-        if( output_file )
-        {
-            vd_t file = bcore_life_s_push_aware( l, bcore_sink_open_file( output_file->sc ) );
-            bcore_sink_a_push_string( file, out );
+        fwrite( out->data, 1, out->size, stdout ); // output can be binary
+    }
+
+    bcore_life_s_discard( l );
+}
+
+/// parses a comma separated list of unsigned integers
+static void parse_uz_list( sc_t sc, bcore_arr_uz_s* arr )
+{
+    bcore_arr_uz_s_clear( arr );
+    while( *sc )
+    {
+        char* end = NULL;
+        bcore_arr_uz_s_push( arr, strtoul( sc, &end, 10 ) );
+        if( end == sc || ( *end != ',' && *end != 0 ) ) ERR( "Invalid list '%s'.", sc );
+        sc = ( *end == ',' ) ? end + 1 : end;
+    }
+}
+
+/// parses a comma separated list of numbers into data (size, space: elements used, allocated; space grows geometrically)
+static void parse_f3_list( sc_t sc, f3_t** data, uz_t* size, uz_t* space )
+{
+    *size = 0;
+    while( *sc )
+    {
+        char* end = NULL;
+        f3_t v = strtod( sc, &end );
+        if( end == sc || ( *end != ',' && *end != 0 ) ) ERR( "Invalid list '%s'.", sc );
+        if( *size == *space )
+        {
+            *space = *space ? *space * 2 : 8;
+            *data = bcore_realloc( *data, sizeof( f3_t ) * *space );
+        }
+        ( *data )[ ( *size )++ ] = v;
+        sc = ( *end == ',' ) ? end + 1 : end;
+    }
+}
+
+/** Runs a parameter sweep; argv[ 1 ] ... argv[ 4 ]: config, assignment, start date, end date; options start at argv[ 5 ].
+ *  Unspecified cycles and rseed lists default to the values of the configuration; weight scales default to 1.
+ */
+static void sweep( int argc, const char** argv )
+{
+    bcore_life_s* l = bcore_life_s_create();
+    sr_s assigner_sr = bcore_life_s_push_sr( l, parser_from_file( argv[ 1 ] ) );
+    if( sr_s_type( &assigner_sr ) != typeof( "assigner_s" ) ) ERR( "Incorrect file '%s'. <assigner_s> expected.", argv[ 1 ] );
+    const assigner_s* assigner = assigner_sr.o;
+    assignment_s* assignment = bcore_life_s_push_aware( l, assignment_s_create_from_path( argv[ 2 ] ) );
+
+    period_s period;
+    period.first.cday = cday_from_dmy_sc( argv[ 3 ] );
+    period.last.cday  = cday_from_dmy_sc( argv[ 4 ] );
+
+    bcore_arr_uz_s* cycles_arr = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s* rseed_arr  = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    bcore_arr_uz_s_push( cycles_arr, assigner->cycles );
+    bcore_arr_uz_s_push( rseed_arr,  assigner->rseed );
+    uz_t weight_scales = 1;
+    uz_t weight_space  = 1;
+    f3_t* weight_scale_arr = bcore_malloc( sizeof( f3_t ) * weight_space );
+    weight_scale_arr[ 0 ] = 1.0;
+    sc_t output_file = NULL;
+
+    for( uz_t i = 5; i < argc; i++ )
+    {
+        if( bcore_strcmp( argv[ i ], "-cycles" ) == 0 )
+        {
+            if( ++i == argc ) ERR( "Option -cycles: list expected." );
+            parse_uz_list( argv[ i ], cycles_arr );
+        }
+        else if( bcore_strcmp( argv[ i ], "-rseed" ) == 0 )
+        {
+            if( ++i == argc ) ERR( "Option -rseed: list expected." );
+            parse_uz_list( argv[ i ], rseed_arr );
+        }
+        else if( bcore_strcmp( argv[ i ], "-weight" ) == 0 )
+        {
+            if( ++i == argc ) ERR( "Option -weight: list expected." );
+            parse_f3_list( argv[ i ], &weight_scale_arr, &weight_scales, &weight_space );
+        }
+        else if( bcore_strcmp( argv[ i ], "-file" ) == 0 )
+        {
+            if( ++i == argc ) ERR( "Option -file: file name expected." );
+            output_file = argv[ i ];
         }
         else
         {
-            st_s_print( out );
+            ERR( "Invalid Argument '%s'", argv[ i ] );
         }
+    }
 
-        bcore_life_s_discard( l );
+    st_s* out = bcore_life_s_push_aware( l, guard_sweep( assigner, assignment, period, cycles_arr, rseed_arr, weight_scale_arr, weight_scales ) );
+    bcore_free( weight_scale_arr );
+
+    if( output_file )
+    {
+        vd_t file = bcore_life_s_push_aware( l, bcore_sink_open_file( output_file ) );
+        bcore_sink_a_push_string( file, out );
+    }
+    else
+    {
+        st_s_print( out );
+    }
+
+    bcore_life_s_discard( l );
+}
+
+int main( int argc, const char** argv )
+{
+    bcore_register_signal_handler( crossing_guard_signal_handler );
+
+    if( argc == 4 && bcore_strcmp( argv[ 1 ], "history_compact" ) == 0 )
+    {
+        char* end = NULL;
+        uz_t months = ( argv[ 3 ][ 0 ] >= '0' && argv[ 3 ][ 0 ] <= '9' ) ? strtoul( argv[ 3 ], &end, 10 ) : 0;
+        if( months == 0 || months > 1200 || *end != 0 ) ERR( "history_compact: months must be an integer from 1 to 1200, got '%s'.", argv[ 3 ] );
+        uz_t cutoff_cday = cday_months_before( cday_today(), months );
+        history_compact( argv[ 2 ], cutoff_cday );
+        char buf[ DMY_SIZE ];
+        st_s_print_d( st_s_createf( "History '%s': folded records before %s.\n", argv[ 2 ], dmy_sc_from_cday( buf, cutoff_cday ) ) );
+    }
+    else if( argc >= 7 && bcore_strcmp( argv[ 1 ], "merge" ) == 0 )
+    {
+        // result files follow the mandatory arguments up to the first option
+        bcore_arr_st_s* merge_files = bcore_arr_st_s_create();
+        uz_t i = 6;
+        for( ; i < argc && argv[ i ][ 0 ] != '-'; i++ ) bcore_arr_st_s_push_sc( merge_files, argv[ i ] );
+        run( argc - 1, argv + 1, i - 1, merge_files );
+        bcore_arr_st_s_discard( merge_files );
+    }
+    else if( argc >= 6 && bcore_strcmp( argv[ 1 ], "sweep" ) == 0 )
+    {
+        sweep( argc - 1, argv + 1 );
+    }
+    else if( argc < 5 )
+    {
+        bcore_msg( "Crossing Guard - Copyright (C) 2017, 2018 Johannes B. Steffens\n" );
+        bcore_msg( "Insufficient input.\n" );
+        bcore_msg( "Usage:\n" );
+        bcore_msg( "   crossing_guard <config_file> <assignment_file|directory|glob> <start_date> <end_date> [-format {dates|persons|assignment|calendar|html_table|analysis|history|csv|csv_days|jsonl|jsonl_days|bin|delta|delta_jsonl} ] [-file <output_file>] [-history <history_file> [-commit]] [-evaluate <edited_assignment_file>] [-watch] [-checkpoint <checkpoint_file> [-resume]] [-stats] [-progress] [-alternatives <k>] [-template <template_file>] [-baseline <published_assignment_file>]\n" );
+        bcore_msg( "   crossing_guard history_compact <history_file> <months>\n" );
+        bcore_msg( "   crossing_guard <config_file> <assignment_file> <start_date> <end_date> -shard <k>/<n> -file <result_file>\n" );
+        bcore_msg( "   crossing_guard merge <config_file> <assignment_file> <start_date> <end_date> <result_file> [<result_file> ...] [options]\n" );
+        bcore_msg( "   crossing_guard sweep <config_file> <assignment_file> <start_date> <end_date> [-cycles <n>,...] [-rseed <n>,...] [-weight <scale>,...] [-file <output_file>]\n" );
+        bcore_msg( "Example: crossing_guard config.txt assignment.txt 01.01.2018 31.03.2018 -format persons\n" );
+        bcore_msg( "Ctrl-C (SIGINT) or SIGTERM stops a solve early: the best plan so far is output; exit code %i.\n", EXIT_STOPPED );
+    }
+    else
+    {
+        run( argc, argv, 5, NULL );
     }
 
     bcore_down( false );
-    return 0;
+    return solve_stopped ? EXIT_STOPPED : 0;
 }
@@ -0,0 +1,720 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "parser.h"
+
+/**********************************************************************************************************************/
+
+typedef struct parser_s
+{
+    sc_t name;          // file name for messages
+    const char* data;
+    uz_t size;
+    uz_t pos;
+    uz_t field_pos;     // position of the last field name
+    char id[ 64 ];      // last type or field name
+    char token[ 64 ];   // last scalar token
+    st_s* string;       // last string
+    bcore_arr_uz_s* cdays;
+    jmp_buf* recover;   // errors return here instead of terminating (optional)
+    st_s* error;        // message of a recovered error
+    vd_t root;          // object in construction (discarded on a recovered error)
+} parser_s;
+
+static void parser_s_err( const parser_s* o, sc_t format, ... )
+{
+    uz_t line = 1;
+    uz_t col  = 1;
+    for( uz_t i = 0; i < o->pos && i < o->size; i++ )
+    {
+        if( o->data[ i ] == '\n' ) { line++; col = 1; } else { col++; }
+    }
+    char msg[ 256 ];
+    va_list args;
+    va_start( args, format );
+    vsnprintf( msg, sizeof( msg ), format, args );
+    va_end( args );
+    if( o->recover )
+    {
+        st_s_clear( o->error );
+        st_s_pushf( o->error, "%s:%zu:%zu: %s", o->name, line, col, msg );
+        longjmp( *o->recover, 1 );
+    }
+    ERR( "%s:%zu:%zu: %s", o->name, line, col, msg );
+}
+
+/// skips whitespace and comments
+static void parser_s_skip( parser_s* o )
+{
+    while( o->pos < o->size )
+    {
+        char c = o->data[ o->pos ];
+        char n = ( o->pos + 1 < o->size ) ? o->data[ o->pos + 1 ] : 0;
+        if( c == ' ' || c == '\t' || c == '\n' || c == '\r' )
+        {
+            o->pos++;
+        }
+        else if( c == '/' && n == '/' )
+        {
+            while( o->pos < o->size && o->data[ o->pos ] != '\n' ) o->pos++;
+        }
+        else if( c == '/' && n == '*' )
+        {
+            uz_t start = o->pos;
+            for( o->pos += 2; o->pos + 1 < o->size; o->pos++ )
+            {
+                if( o->data[ o->pos ] == '*' && o->data[ o->pos + 1 ] == '/' ) break;
+            }
+            if( o->pos + 1 >= o->size )
+            {
+                o->pos = start;
+                parser_s_err( o, "Unterminated comment." );
+            }
+            o->pos += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/// consumes sc (after whitespace) if present
+static bl_t parser_s_try( parser_s* o, sc_t sc )
+{
+    parser_s_skip( o );
+    uz_t n = bcore_strlen( sc );
+    if( o->pos + n > o->size || memcmp( o->data + o->pos, sc, n ) != 0 ) return false;
+    o->pos += n;
+    return true;
+}
+
+static void parser_s_expect( parser_s* o, sc_t sc )
+{
+    if( !parser_s_try( o, sc ) ) parser_s_err( o, "'%s' expected.", sc );
+}
+
+static bl_t parser_s_id_char( char c )
+{
+    return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) || c == '_';
+}
+
+/// reads an identifier into o->id
+static sc_t parser_s_id( parser_s* o )
+{
+    parser_s_skip( o );
+    uz_t n = 0;
+    while( o->pos < o->size && parser_s_id_char( o->data[ o->pos ] ) )
+    {
+        if( n + 1 == sizeof( o->id ) ) parser_s_err( o, "Name too long." );
+        o->id[ n++ ] = o->data[ o->pos++ ];
+    }
+    if( n == 0 ) parser_s_err( o, "Name expected." );
+    o->id[ n ] = 0;
+    return o->id;
+}
+
+/// '<type>'
+static void parser_s_open( parser_s* o, sc_t type )
+{
+    parser_s_expect( o, "<" );
+    uz_t pos = o->pos;
+    if( bcore_strcmp( parser_s_id( o ), type ) != 0 )
+    {
+        o->pos = pos;
+        parser_s_err( o, "<%s> expected.", type );
+    }
+    parser_s_expect( o, ">" );
+}
+
+/// 'name:' (returns name) or '</>' (returns NULL)
+static sc_t parser_s_field( parser_s* o )
+{
+    if( parser_s_try( o, "</>" ) ) return NULL;
+    o->field_pos = o->pos;
+    sc_t name = parser_s_id( o );
+    parser_s_expect( o, ":" );
+    return name;
+}
+
+static void parser_s_unknown_field( parser_s* o, sc_t type )
+{
+    o->pos = o->field_pos;
+    parser_s_err( o, "Unknown field '%s' in %s.", o->id, type );
+}
+
+/// scalar token up to the closing '</>' into o->token
+static sc_t parser_s_token( parser_s* o )
+{
+    parser_s_skip( o );
+    uz_t n = 0;
+    while( o->pos < o->size && o->data[ o->pos ] != '<' && o->data[ o->pos ] > ' ' )
+    {
+        if( n + 1 == sizeof( o->token ) ) parser_s_err( o, "Value too long." );
+        o->token[ n++ ] = o->data[ o->pos++ ];
+    }
+    o->token[ n ] = 0;
+    return o->token;
+}
+
+/// quoted string into o->string
+static void parser_s_string( parser_s* o )
+{
+    parser_s_expect( o, "\"" );
+    st_s_clear( o->string );
+    uz_t start = o->pos;
+    while( o->pos < o->size && o->data[ o->pos ] != '"' )
+    {
+        if( o->data[ o->pos ] == '\\' && o->pos + 1 < o->size )
+        {
+            st_s_push_sc_n( o->string, o->data + start, o->pos - start );
+            char c = o->data[ o->pos + 1 ];
+            st_s_push_char( o->string, c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c );
+            o->pos += 2;
+            start = o->pos;
+        }
+        else
+        {
+            o->pos++;
+        }
+    }
+    if( o->pos == o->size ) parser_s_err( o, "Unterminated string." );
+    st_s_push_sc_n( o->string, o->data + start, o->pos - start );
+    o->pos++;
+}
+
+/**********************************************************************************************************************/
+/// typed values
+
+static void parser_s_st( parser_s* o, st_s* st )
+{
+    parser_s_open( o, "st_s" );
+    parser_s_string( o );
+    st_s_copy( st, o->string );
+    parser_s_expect( o, "</>" );
+}
+
+static bl_t parser_s_bl( parser_s* o )
+{
+    parser_s_open( o, "bl_t" );
+    uz_t pos = o->pos;
+    sc_t sc = parser_s_token( o );
+    bl_t v = false;
+    if( bcore_strcmp( sc, "true" ) == 0 )
+    {
+        v = true;
+    }
+    else if( bcore_strcmp( sc, "false" ) != 0 )
+    {
+        o->pos = pos;
+        parser_s_err( o, "Boolean expected." );
+    }
+    parser_s_expect( o, "</>" );
+    return v;
+}
+
+/// type: uz_t or u2_t
+static uz_t parser_s_uz( parser_s* o, sc_t type )
+{
+    parser_s_open( o, type );
+    uz_t pos = o->pos;
+    sc_t sc = parser_s_token( o );
+    char* end = NULL;
+    uz_t v = strtoull( sc, &end, 10 );
+    if( end == sc || *end != 0 )
+    {
+        o->pos = pos;
+        parser_s_err( o, "Unsigned integer expected." );
+    }
+    parser_s_expect( o, "</>" );
+    return v;
+}
+
+static f3_t parser_s_f3( parser_s* o )
+{
+    parser_s_open( o, "f3_t" );
+    uz_t pos = o->pos;
+    sc_t sc = parser_s_token( o );
+    char* end = NULL;
+    f3_t v = strtod( sc, &end );
+    if( end == sc || *end != 0 )
+    {
+        o->pos = pos;
+        parser_s_err( o, "Number expected." );
+    }
+    parser_s_expect( o, "</>" );
+    return v;
+}
+
+/// <date_s>:<st_s>"DD.MM.YYYY"</></> (returns cday)
+static uz_t parser_s_date( parser_s* o )
+{
+    parser_s_open( o, "date_s" );
+    parser_s_expect( o, ":" );
+    parser_s_open( o, "st_s" );
+    parser_s_skip( o );
+    uz_t pos = o->pos;
+    parser_s_string( o );
+    uz_t cday = 0;
+    if( !cday_parse_dmy_sc( o->string->sc, &cday ) )
+    {
+        o->pos = pos;
+        parser_s_err( o, "Invalid date '%s' (expected DD.MM.YYYY).", o->string->sc );
+    }
+    parser_s_expect( o, "</>" );
+    parser_s_expect( o, "</>" );
+    return cday;
+}
+
+static void parser_s_date_arr( parser_s* o, date_arr_s* arr )
+{
+    parser_s_open( o, "date_arr_s" );
+    bcore_arr_uz_s_clear( o->cdays );
+    while( !parser_s_try( o, "</>" ) ) bcore_arr_uz_s_push( o->cdays, parser_s_date( o ) );
+    bcore_array_a_set_size( ( bcore_array* )arr, o->cdays->size );
+    for( uz_t i = 0; i < arr->size; i++ ) arr->data[ i ].cday = o->cdays->data[ i ];
+}
+
+static void parser_s_period( parser_s* o, period_s* period )
+{
+    parser_s_open( o, "period_s" );
+    for( sc_t field = parser_s_field( o ); field; field = parser_s_field( o ) )
+    {
+        if(      bcore_strcmp( field, "first" ) == 0 ) period->first.cday = parser_s_date( o );
+        else if( bcore_strcmp( field, "last"  ) == 0 ) period->last.cday  = parser_s_date( o );
+        else parser_s_unknown_field( o, "period_s" );
+    }
+}
+
+static void parser_s_period_arr( parser_s* o, period_arr_s* arr )
+{
+    parser_s_open( o, "period_arr_s" );
+    bcore_array_a_set_size( ( bcore_array* )arr, 0 );
+    while( !parser_s_try( o, "</>" ) )
+    {
+        bcore_array_a_set_size( ( bcore_array* )arr, arr->size + 1 );
+        parser_s_period( o, &arr->data[ arr->size - 1 ] );
+    }
+}
+
+static void parser_s_demand_arr( parser_s* o, demand_arr_s* arr )
+{
+    parser_s_open( o, "demand_arr_s" );
+    bcore_array_a_set_size( ( bcore_array* )arr, 0 );
+    while( !parser_s_try( o, "</>" ) )
+    {
+        bcore_array_a_set_size( ( bcore_array* )arr, arr->size + 1 );
+        demand_s* demand = &arr->data[ arr->size - 1 ];
+        parser_s_open( o, "demand_s" );
+        for( sc_t field = parser_s_field( o ); field; field = parser_s_field( o ) )
+        {
+            if(      bcore_strcmp( field, "period" ) == 0 ) parser_s_period( o, &demand->period );
+            else if( bcore_strcmp( field, "count"  ) == 0 ) demand->count = parser_s_uz( o, "uz_t" );
+            else parser_s_unknown_field( o, "demand_s" );
+        }
+    }
+}
+
+static void parser_s_arr_uz( parser_s* o, bcore_arr_uz_s* arr )
+{
+    parser_s_open( o, "bcore_arr_uz_s" );
+    bcore_arr_uz_s_clear( arr );
+    while( !parser_s_try( o, "</>" ) ) bcore_arr_uz_s_push( arr, parser_s_uz( o, "uz_t" ) );
+}
+
+/// weekday list "mo, tu, ..." (as weekday_availability_s_set_weekdays)
+static u0_t parser_s_weekdays( parser_s* o )
+{
+    parser_s_open( o, "st_s" );
+    parser_s_skip( o );
+    uz_t pos = o->pos;
+    parser_s_string( o );
+    u0_t flags = 0;
+    sc_t sc = o->string->sc;
+    for( uz_t count = 1; *sc; count++ )
+    {
+        while( *sc == ' ' || *sc == '\t' ) sc++;
+
+        // weekdays after the first are separated by a comma
+        bl_t separated = ( count == 1 || *sc == ',' );
+        if( count > 1 && separated )
+        {
+            sc++;
+            while( *sc == ' ' || *sc == '\t' ) sc++;
+        }
+
+        uz_t wday = 7;
+        for( uz_t i = 0; i < 7 && separated; i++ )
+        {
+            if( strncmp( sc, sc_from_wday( i ), 2 ) == 0 )
+            {
+                wday = i;
+                break;
+            }
+        }
+        if( wday == 7 )
+        {
+            o->pos = pos;
+            parser_s_err( o, "Cannot parse weekday %zu in string \"%s\"", count, o->string->sc );
+        }
+        flags |= 1 << wday;
+        sc += 2;
+        while( *sc == ' ' || *sc == '\t' ) sc++;
+    }
+    parser_s_expect( o, "</>" );
+    return flags;
+}
+
+/**********************************************************************************************************************/
+/// objects
+
+static void parser_s_weekday_availability( parser_s* o, weekday_availability_s* w )
+{
+    parser_s_open( o, "weekday_availability_s" );
+    for( sc_t field = parser_s_field( o ); field; field = parser_s_field( o ) )
+    {
+        if(      bcore_strcmp( field, "weekdays"       ) == 0 ) w->weekday_flags  = parser_s_weekdays( o );
+        else if( bcore_strcmp( field, "weekly_period"  ) == 0 ) w->weekly_period  = parser_s_uz( o, "uz_t" );
+        else if( bcore_strcmp( field, "including_week" ) == 0 ) w->including_week = parser_s_uz( o, "uz_t" );
+        else parser_s_unknown_field( o, "weekday_availability_s" );
+    }
+}
+
+static void parser_s_preferences( parser_s* o, preferences_s* p )
+{
+    parser_s_open( o, "preferences_s" );
+    for( sc_t field = parser_s_field( o ); field; field = parser_s_field( o ) )
+    {
+        if(      bcore_strcmp( field, "weight"               ) == 0 ) p->weight = parser_s_f3( o );
+        else if( bcore_strcmp( field, "weekday_availability" ) == 0 ) parser_s_weekday_availability( o, &p->weekday_availability );
+        else if( bcore_strcmp( field, "always_same_workday"  ) == 0 ) p->always_same_workday = parser_s_bl( o );
+        else if( bcore_strcmp( field, "included_dates"       ) == 0 ) parser_s_date_arr( o, &p->included_dates );
+        else if( bcore_strcmp( field, "excluded_dates"       ) == 0 ) parser_s_date_arr( o, &p->excluded_dates );
+        else if( bcore_strcmp( field, "excluded_periods"     ) == 0 ) parser_s_period_arr( o, &p->excluded_periods );
+        else parser_s_unknown_field( o, "preferences_s" );
+    }
+}
+
+/// "any" or weekday (as person_s_set_assigned_weekday)
+static uz_t parser_s_assigned_weekday( parser_s* o )
+{
+    parser_s_open( o, "st_s" );
+    parser_s_skip( o );
+    uz_t pos = o->pos;
+    parser_s_string( o );
+    uz_t wday = 8;
+    if( bcore_strcmp( o->string->sc, "any" ) == 0 ) wday = 7;
+    for( uz_t i = 0; i < 7 && wday == 8; i++ ) if( bcore_strcmp( o->string->sc, sc_from_wday( i ) ) == 0 ) wday = i;
+    if( wday == 8 )
+    {
+        o->pos = pos;
+        parser_s_err( o, "invalid weekday string '%s'", o->string->sc );
+    }
+    parser_s_expect( o, "</>" );
+    return wday;
+}
+
+static void parser_s_person( parser_s* o, person_s* p )
+{
+    parser_s_open( o, "person_s" );
+    for( sc_t field = parser_s_field( o ); field; field = parser_s_field( o ) )
+    {
+        if(      bcore_strcmp( field, "name"             ) == 0 ) parser_s_st( o, &p->name );
+        else if( bcore_strcmp( field, "preferences"      ) == 0 ) parser_s_preferences( o, &p->preferences );
+        else if( bcore_strcmp( field, "assigned_weekday" ) == 0 ) p->assigned_nweekday = parser_s_assigned_weekday( o );
+        else if( bcore_strcmp( field, "assigned_dates"   ) == 0 ) parser_s_date_arr( o, &p->assigned_dates );
+        else parser_s_unknown_field( o, "person_s" );
+    }
+}
+
+static assignment_s* parser_s_assignment( parser_s* o )
+{
+    assignment_s* assignment = assignment_s_create();
+    o->root = assignment;
+    parser_s_open( o, "assignment_s" );
+    while( !parser_s_try( o, "</>" ) )
+    {
+        // links are moved in directly; space grows geometrically
+        if( assignment->size == assignment->space )
+        {
+            assignment_s_reserve( assignment, assignment->space > 0 ? assignment->space * 2 : 64 );
+        }
+        person_s* p = person_s_create();
+        assignment->data[ assignment->size++ ] = p;
+        parser_s_person( o, p );
+    }
+    return assignment;
+}
+
+static assigner_s* parser_s_assigner( parser_s* o )
+{
+    assigner_s* a = assigner_s_create();
+    o->root = a;
+    parser_s_open( o, "assigner_s" );
+    for( sc_t field = parser_s_field( o ); field; field = parser_s_field( o ) )
+    {
+        if(      bcore_strcmp( field, "mo"             ) == 0 ) a->mo = parser_s_bl( o );
+        else if( bcore_strcmp( field, "tu"             ) == 0 ) a->tu = parser_s_bl( o );
+        else if( bcore_strcmp( field, "we"             ) == 0 ) a->we = parser_s_bl( o );
+        else if( bcore_strcmp( field, "th"             ) == 0 ) a->th = parser_s_bl( o );
+        else if( bcore_strcmp( field, "fr"             ) == 0 ) a->fr = parser_s_bl( o );
+        else if( bcore_strcmp( field, "sa"             ) == 0 ) a->sa = parser_s_bl( o );
+        else if( bcore_strcmp( field, "su"             ) == 0 ) a->su = parser_s_bl( o );
+        else if( bcore_strcmp( field, "vacation_arr"   ) == 0 ) parser_s_period_arr( o, &a->vacation_arr );
+        else if( bcore_strcmp( field, "holidays"       ) == 0 ) parser_s_date_arr( o, &a->holidays );
+        else if( bcore_strcmp( field, "rseed"          ) == 0 ) a->rseed = parser_s_uz( o, "u2_t" );
+        else if( bcore_strcmp( field, "cycles"         ) == 0 ) a->cycles = parser_s_uz( o, "uz_t" );
+        else if( bcore_strcmp( field, "score_function" ) == 0 ) parser_s_st( o, &a->score_function );
+        else if( bcore_strcmp( field, "score_scale"    ) == 0 ) a->score_scale = parser_s_f3( o );
+        else if( bcore_strcmp( field, "score_cap"      ) == 0 ) a->score_cap = parser_s_f3( o );
+        else if( bcore_strcmp( field, "quota_weight"   ) == 0 ) a->quota_weight = parser_s_f3( o );
+        else if( bcore_strcmp( field, "pin_weekdays"   ) == 0 ) a->pin_weekdays = parser_s_bl( o );
+        else if( bcore_strcmp( field, "demand"         ) == 0 ) a->demand = parser_s_uz( o, "uz_t" );
+        else if( bcore_strcmp( field, "weekday_demand" ) == 0 ) parser_s_arr_uz( o, &a->weekday_demand );
+        else if( bcore_strcmp( field, "demand_arr"     ) == 0 ) parser_s_demand_arr( o, &a->demand_arr );
+        else if( bcore_strcmp( field, "search"         ) == 0 ) parser_s_st( o, &a->search );
+        else if( bcore_strcmp( field, "collapse_classes" ) == 0 ) a->collapse_classes = parser_s_bl( o );
+        else parser_s_unknown_field( o, "assigner_s" );
+    }
+    return a;
+}
+
+/**********************************************************************************************************************/
+
+/// type name of the first object without consuming it (empty if none)
+static sc_t parser_s_peek_type( parser_s* o )
+{
+    uz_t pos = o->pos;
+    o->id[ 0 ] = 0;
+    if( parser_s_try( o, "<" ) && o->pos < o->size && parser_s_id_char( o->data[ o->pos ] ) ) parser_s_id( o );
+    o->pos = pos;
+    return o->id;
+}
+
+static bl_t parser_schema_type( sc_t type )
+{
+    return bcore_strcmp( type, "assigner_s" ) == 0 || bcore_strcmp( type, "assignment_s" ) == 0;
+}
+
+static sr_s parser_s_parse( parser_s* o )
+{
+    sr_s sr = sr_null();
+    sc_t type = parser_s_peek_type( o );
+    if( bcore_strcmp( type, "assigner_s" ) == 0 )
+    {
+        sr = sr_asd( parser_s_assigner( o ) );
+    }
+    else if( bcore_strcmp( type, "assignment_s" ) == 0 )
+    {
+        sr = sr_asd( parser_s_assignment( o ) );
+    }
+    else
+    {
+        parser_s_skip( o );
+        parser_s_err( o, "<assigner_s> or <assignment_s> expected." );
+    }
+    return sr;
+}
+
+/// parses with errors returning to this frame (returns false on error)
+static bl_t parser_s_parse_recover( parser_s* o, sr_s* sr )
+{
+    jmp_buf recover;
+    o->recover = &recover;
+    if( setjmp( recover ) != 0 ) return false;
+    *sr = parser_s_parse( o );
+    return true;
+}
+
+sr_s parser_from_data( sc_t name, const char* data, uz_t size )
+{
+    parser_s o = { .name = name, .data = data, .size = size };
+    o.string = st_s_create();
+    o.cdays  = bcore_arr_uz_s_create();
+    sr_s sr = parser_s_parse( &o );
+    st_s_discard( o.string );
+    bcore_arr_uz_s_discard( o.cdays );
+    return sr;
+}
+
+sr_s parser_try_from_data( sc_t name, const char* data, uz_t size, st_s* err )
+{
+    parser_s o = { .name = name, .data = data, .size = size, .error = err };
+    o.string = st_s_create();
+    o.cdays  = bcore_arr_uz_s_create();
+    sr_s sr = sr_null();
+    if( !parser_s_parse_recover( &o, &sr ) && o.root ) sr_down( sr_asd( o.root ) );
+    st_s_discard( o.string );
+    bcore_arr_uz_s_discard( o.cdays );
+    return sr;
+}
+
+/// maps file read-only (*map: NULL for an empty file); returns false with a message in err (NULL: terminates)
+static bl_t parser_map_file( sc_t file, const char** map, uz_t* size, st_s* err )
+{
+    sc_t msg = NULL;
+    int fd = open( file, O_RDONLY );
+    struct stat st;
+    if( fd < 0 )
+    {
+        msg = "Cannot open file";
+    }
+    else if( fstat( fd, &st ) != 0 )
+    {
+        msg = "Cannot access file";
+    }
+    else
+    {
+        *size = st.st_size;
+        *map = ( *size > 0 ) ? mmap( NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0 ) : NULL;
+        if( *map == MAP_FAILED ) msg = "Cannot map file";
+    }
+    if( fd >= 0 ) close( fd );
+    if( !msg ) return true;
+    if( !err ) ERR( "%s '%s'.", msg, file );
+    st_s_clear( err );
+    st_s_pushf( err, "%s '%s'.", msg, file );
+    return false;
+}
+
+sr_s parser_from_file( sc_t file )
+{
+    const char* map = NULL;
+    uz_t size = 0;
+    parser_map_file( file, &map, &size, NULL );
+
+    // other types (e.g. shard results, checkpoints) are parsed by bcore
+    parser_s peek = { .name = file, .data = map, .size = size };
+    if( !parser_schema_type( parser_s_peek_type( &peek ) ) )
+    {
+        if( map ) munmap( ( vd_t )map, size );
+        return bcore_txt_ml_from_file( file );
+    }
+
+    sr_s sr = parser_from_data( file, map, size );
+    munmap( ( vd_t )map, size );
+    return sr;
+}
+
+sr_s parser_try_from_file( sc_t file, st_s* err )
+{
+    const char* map = NULL;
+    uz_t size = 0;
+    if( !parser_map_file( file, &map, &size, err ) ) return sr_null();
+    sr_s sr = parser_try_from_data( file, map, size, err );
+    if( map ) munmap( ( vd_t )map, size );
+    return sr;
+}
+
+/**********************************************************************************************************************/
+
+static st_s* parser_selftest( void )
+{
+    st_s* log = st_s_create();
+    bcore_life_s* l = bcore_life_s_create();
+
+    sc_t sc_assignment =
+        "/* comment */ <assignment_s>\n"
+        "  <person_s> // comment\n"
+        "    name:<st_s>\"A \\\"B\\\"\"</>\n"
+        "    preferences:<preferences_s>\n"
+        "      weight: <f3_t>0.5</>\n"
+        "      weekday_availability:<weekday_availability_s> weekdays:<st_s>\"tu, fr\"</> weekly_period:<uz_t>2</> </>\n"
+        "      always_same_workday:<bl_t>false</>\n"
+        "      excluded_periods:<period_arr_s> <period_s> first:<date_s>:<st_s>\"08.01.2018\"</></> last:<date_s>:<st_s>\"31.01.2018\"</></> </> </>\n"
+        "    </>\n"
+        "    assigned_weekday:<st_s>\"fr\"</>\n"
+        "    assigned_dates:<date_arr_s> <date_s>:<st_s>\"17.12.2017\"</></> <date_s>:<st_s>\"18.12.2017\"</></> </>\n"
+        "  </>\n"
+        "  <person_s> name:<st_s>\"C\"</> </>\n"
+        "</>\n";
+
+    assignment_s* a = bcore_life_s_push_sr( l, parser_from_data( "selftest", sc_assignment, bcore_strlen( sc_assignment ) ) ).o;
+    ASSERT( a->size == 2 );
+    const person_s* p = a->data[ 0 ];
+    ASSERT( st_s_cmp_sc( &p->name, "A \"B\"" ) == 0 );
+    ASSERT( p->preferences.weight == 0.5 );
+    ASSERT( p->preferences.weekday_availability.weekday_flags == ( ( 1 << 1 ) | ( 1 << 4 ) ) );
+    ASSERT( p->preferences.weekday_availability.weekly_period == 2 );
+    ASSERT( p->preferences.weekday_availability.including_week == 1 );
+    ASSERT( !p->preferences.always_same_workday );
+    ASSERT( p->preferences.excluded_periods.size == 1 );
+    ASSERT( p->preferences.excluded_periods.data[ 0 ].last.cday == cday_from_dmy_sc( "31.01.2018" ) );
+    ASSERT( p->assigned_nweekday == 4 );
+    ASSERT( p->assigned_dates.size == 2 && p->assigned_dates.data[ 1 ].cday == cday_from_dmy_sc( "18.12.2017" ) );
+
+    // defaults of an empty person equal those of the reflective parser
+    person_s* defaults = bcore_life_s_push_aware( l, person_s_create() );
+    st_s_copy_sc( &defaults->name, "C" );
+    ASSERT( bcore_compare_aware( defaults, a->data[ 1 ] ) == 0 );
+
+    // round trip through the reflective writer
+    st_s* text = bcore_life_s_push_aware( l, st_s_create() );
+    bcore_txt_ml_a_to_string( a, text );
+    assignment_s* b = bcore_life_s_push_sr( l, parser_from_data( "selftest", text->sc, text->size ) ).o;
+    ASSERT( bcore_compare_aware( a, b ) == 0 );
+
+    assigner_s* assigner = bcore_life_s_push_aware( l, assigner_s_create() );
+    assigner->sa = true;
+    assigner->cycles = 7;
+    st_s_copy_sc( &assigner->search, "branch" );
+    assigner->collapse_classes = true;
+    bcore_arr_uz_s_push( &assigner->weekday_demand, 2 );
+    bcore_array_a_push( ( bcore_array* )&assigner->holidays, sr_uz( cday_from_dmy_sc( "01.05.2018" ) ) );
+    st_s_clear( text );
+    bcore_txt_ml_a_to_string( assigner, text );
+    assigner_s* assigner2 = bcore_life_s_push_sr( l, parser_from_data( "selftest", text->sc, text->size ) ).o;
+    ASSERT( bcore_compare_aware( assigner, assigner2 ) == 0 );
+
+    // recovered error: position reported, partial object discarded
+    {
+        sc_t sc_broken = "<assignment_s>\n  <person_s> name:<st_s>\"X\"</> weight:<f3_t>1</> </>\n</>\n";
+        st_s* err = bcore_life_s_push_aware( l, st_s_create() );
+        sr_s sr = parser_try_from_data( "selftest", sc_broken, bcore_strlen( sc_broken ), err );
+        ASSERT( sr.o == NULL );
+        ASSERT( strstr( err->sc, "selftest:2:" ) != NULL );
+        ASSERT( parser_try_from_file( "/nonexistent/assignment.txt", err ).o == NULL && err->size > 0 );
+    }
+
+    st_s_pushf( log, "parser: ok\n" );
+    bcore_life_s_discard( l );
+    return log;
+}
+
+/**********************************************************************************************************************/
+
+vd_t parser_signal_handler( const bcore_signal_s* o )
+{
+    switch( bcore_signal_s_handle_type( o, typeof( "parser" ) ) )
+    {
+        case TYPEOF_selftest:
+        {
+            st_s_print_d( parser_selftest() );
+        }
+        break;
+
+        default: break;
+    }
+    return NULL;
+}
+
+/**********************************************************************************************************************/
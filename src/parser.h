@@ -0,0 +1,47 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Schema-specific loader for assigner_s and assignment_s files
+ *  Reads the file through a memory mapping in one pass and parses fields, dates and weekday lists directly into
+ *  their final representation (no reflection, no intermediate strings per field). Accepts the same txt_ml syntax as
+ *  bcore_txt_ml_from_file (including C/C++ comments). Errors are reported with line and column.
+ *  The schema must match the reflective definitions in guard.c.
+ */
+
+/// drop-in for bcore_txt_ml_from_file: assigner_s and assignment_s are parsed by the schema loader, other types by bcore
+sr_s parser_from_file( sc_t file );
+
+/// parses an assigner_s or assignment_s object from data (size bytes); name is used in error messages
+sr_s parser_from_data( sc_t name, const char* data, uz_t size );
+
+/** Variants for interactive use (e.g. watch mode): a missing file or a syntax error returns sr_null with the message
+ *  (file, line and column) in err instead of terminating. Only assigner_s and assignment_s are accepted.
+ */
+sr_s parser_try_from_data( sc_t name, const char* data, uz_t size, st_s* err );
+sr_s parser_try_from_file( sc_t file, st_s* err );
+
+/**********************************************************************************************************************/
+
+vd_t parser_signal_handler( const bcore_signal_s* o );
+
+/**********************************************************************************************************************/
+
+#endif // PARSER_H
@@ -0,0 +1,180 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include "shard.h"
+
+/**********************************************************************************************************************/
+
+static sc_t shard_result_s_def = "shard_result_s = "
+"{"
+    "aware_t _;      "
+    "uz_t shard;     "
+    "uz_t shards;    "
+    "u2_t rseed;     "
+    "uz_t cycles;    "
+    "period_s period;"
+    "bl_t found;     "
+    "uz_t cycle;     "
+    "u2_t seed;      "
+    "f3_t score;     "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( shard_result_s, shard_result_s_def )
+
+shard_result_s* shard_result_s_create_solved( const assigner_s* assigner, const assignment_s* src, period_s period, uz_t shard, uz_t shards )
+{
+    if( shards == 0 || shard >= shards ) ERR( "Invalid shard %zu/%zu (0 <= k < n).", shard, shards );
+    if( assigner_s_branch_search( assigner ) ) ERR( "Sharding requires search 'random'." );
+
+    shard_result_s* o = shard_result_s_create();
+    o->shard  = shard;
+    o->shards = shards;
+    o->rseed  = assigner->rseed;
+    o->cycles = assigner->cycles;
+    o->period = period;
+
+    uz_t first = ( assigner->cycles * shard ) / shards;
+    uz_t end   = ( assigner->cycles * ( shard + 1 ) ) / shards;
+    if( first == end ) return o;
+
+    solver_s* solver = solver_s_create();
+    solver_s_setup( solver, assigner, src, period );
+    trial_s* best = trial_s_create();
+    o->found = solver_s_solve_range( solver, assigner->rseed, first, end, best, NULL, NULL );
+    o->cycle = best->cycle;
+    o->seed  = best->rseed;
+    o->score = best->score;
+    trial_s_discard( best );
+    solver_s_discard( solver );
+    return o;
+}
+
+assignment_s* shard_merge( const assigner_s* assigner, const assignment_s* src, period_s period, const bcore_arr_st_s* files )
+{
+    if( files->size == 0 ) ERR( "No shard results to merge." );
+
+    bcore_life_s* l = bcore_life_s_create();
+    bcore_arr_uz_s* seen = bcore_life_s_push_aware( l, bcore_arr_uz_s_create() );
+    uz_t shards = 0;
+
+    solver_s* solver = bcore_life_s_push_aware( l, solver_s_create() );
+    solver_s_setup( solver, assigner, src, period );
+    trial_s* trial = bcore_life_s_push_aware( l, trial_s_create() );
+    trial_s* best  = bcore_life_s_push_aware( l, trial_s_create() );
+    bl_t found = false;
+
+    for( uz_t i = 0; i < files->size; i++ )
+    {
+        sc_t file = files->data[ i ]->sc;
+        sr_s sr = bcore_life_s_push_sr( l, bcore_txt_ml_from_file( file ) );
+        if( sr_s_type( &sr ) != TYPEOF_shard_result_s ) ERR( "Incorrect file '%s'. <shard_result_s> expected.", file );
+        const shard_result_s* r = sr.o;
+
+        if( i == 0 )
+        {
+            shards = r->shards;
+            bcore_arr_uz_s_fill( seen, shards, 0 );
+        }
+        if( r->shards != shards || r->shard >= shards ) ERR( "'%s': shard %zu/%zu does not match %zu shards.", file, r->shard, r->shards, shards );
+        if( r->rseed != assigner->rseed || r->cycles != assigner->cycles ) ERR( "'%s': rseed or cycles differ from configuration.", file );
+        if( r->period.first.cday != period.first.cday || r->period.last.cday != period.last.cday ) ERR( "'%s': period differs.", file );
+        if( seen->data[ r->shard ]++ ) ERR( "'%s': shard %zu/%zu appears twice.", file, r->shard, r->shards );
+        if( !r->found ) continue;
+
+        // scores are recomputed so that selection does not depend on the textual representation
+        trial_s_run( trial, solver, r->seed );
+        trial->cycle = r->cycle;
+        if( !found || trial->score > best->score || ( trial->score == best->score && trial->cycle < best->cycle ) )
+        {
+            trial_s_copy_state( best, trial );
+            found = true;
+        }
+    }
+
+    for( uz_t i = 0; i < shards; i++ ) if( !seen->data[ i ] ) ERR( "Shard %zu/%zu is missing.", i, shards );
+
+    assignment_s* assignment = found ? solver_s_create_assignment( solver, src, best ) : assignment_s_clone( src );
+    bcore_life_s_discard( l );
+    return assignment;
+}
+
+/**********************************************************************************************************************/
+
+static void shard_selftest( void )
+{
+    bcore_life_s* l = bcore_life_s_create();
+
+    const assignment_s* src = bcore_life_s_push_aware( l, guard_selftest_assignment_create() );
+    period_s period = guard_selftest_period();
+    assigner_s* assigner = bcore_life_s_push_aware( l, assigner_s_create() );
+    assigner->cycles = 5;
+
+    const assignment_s* direct = bcore_life_s_push_aware( l, assigner_s_create_assignment( assigner, src, period ) );
+
+    // more shards than cycles leaves slices empty
+    uz_t shards_arr[] = { 1, 2, 3, 8 };
+    for( uz_t i = 0; i < sizeof( shards_arr ) / sizeof( uz_t ); i++ )
+    {
+        uz_t shards = shards_arr[ i ];
+        bcore_arr_st_s* files = bcore_arr_st_s_create();
+        for( uz_t k = 0; k < shards; k++ )
+        {
+            st_s* file = guard_selftest_temp_file_create( "shard" );
+            shard_result_s* r = shard_result_s_create_solved( assigner, src, period, k, shards );
+            ASSERT( r->found == ( ( assigner->cycles * k ) / shards < ( assigner->cycles * ( k + 1 ) ) / shards ) );
+            bcore_txt_ml_a_to_file( r, file->sc );
+            shard_result_s_discard( r );
+            bcore_arr_st_s_push_st( files, file );
+            st_s_discard( file );
+        }
+
+        assignment_s* merged = shard_merge( assigner, src, period, files );
+        ASSERT( bcore_compare_aware( merged, direct ) == 0 );
+        assignment_s_discard( merged );
+
+        for( uz_t k = 0; k < files->size; k++ ) unlink( files->data[ k ]->sc );
+        bcore_arr_st_s_discard( files );
+    }
+
+    bcore_life_s_discard( l );
+}
+
+/**********************************************************************************************************************/
+
+vd_t shard_signal_handler( const bcore_signal_s* o )
+{
+    switch( bcore_signal_s_handle_type( o, typeof( "shard" ) ) )
+    {
+        case TYPEOF_init1:
+        {
+            BCORE_REGISTER_OBJECT( shard_result_s );
+        }
+        break;
+
+        case TYPEOF_selftest:
+        {
+            shard_selftest();
+        }
+        break;
+
+        default: break;
+    }
+    return NULL;
+}
+
+/**********************************************************************************************************************/
+
@@ -0,0 +1,57 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Seed Sharding
+ *  The cycles of assigner_s_create_assignment are split into n contiguous slices of the seed sequence.
+ *  Shard k (0 <= k < n) solves its slice and stores its best trial in a small result file (txt_ml).
+ *  Merging picks the highest score; ties are resolved by the lowest cycle. Hence n shards together
+ *  give exactly the single process result.
+ */
+
+#define TYPEOF_shard_result_s typeof( "shard_result_s" )
+typedef struct shard_result_s
+{
+    aware_t _;
+    uz_t shard;
+    uz_t shards;
+    u2_t rseed;      // rseed of assigner
+    uz_t cycles;     // cycles of assigner (all shards)
+    period_s period;
+    bl_t found;      // slice was not empty
+    uz_t cycle;      // best cycle in slice
+    u2_t seed;       // seed of best cycle
+    f3_t score;      // informational; merge recomputes scores
+} shard_result_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( shard_result_s )
+
+/// solves shard k of n
+shard_result_s* shard_result_s_create_solved( const assigner_s* assigner, const assignment_s* src, period_s period, uz_t shard, uz_t shards );
+
+/// creates the assignment of the global best of all shard results (files); checks that the results form a complete set
+assignment_s* shard_merge( const assigner_s* assigner, const assignment_s* src, period_s period, const bcore_arr_st_s* files );
+
+/**********************************************************************************************************************/
+
+vd_t shard_signal_handler( const bcore_signal_s* o );
+
+/**********************************************************************************************************************/
+
+#endif // SHARD_H
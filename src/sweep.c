@@ -0,0 +1,131 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "sweep.h"
+
+/**********************************************************************************************************************/
+
+typedef struct sweep_task_s
+{
+    const solver_s** solvers; // per weight scale
+    sweep_point_s* points;
+} sweep_task_s;
+
+static void sweep_task( vd_t arg, uz_t index )
+{
+    sweep_task_s* o = arg;
+    sweep_point_s* point = &o->points[ index ];
+    const solver_s* solver = o->solvers[ point->weight_scale_index ];
+    trial_s* best = trial_s_create();
+    f3_t time_start = guard_time_ms();
+    solver_s_solve( solver, point->rseed, point->cycles, best );
+    point->time       = guard_time_ms() - time_start;
+    point->score      = best->score;
+    point->fail_count = best->fail_count;
+    trial_s_discard( best );
+}
+
+/**********************************************************************************************************************/
+
+st_s* guard_sweep
+(
+    const assigner_s* assigner,
+    const assignment_s* src,
+    period_s period,
+    const bcore_arr_uz_s* cycles_arr,
+    const bcore_arr_uz_s* rseed_arr,
+    const f3_t* weight_scale_arr,
+    uz_t weight_scales
+)
+{
+    for( uz_t i = 0; i < cycles_arr->size; i++ ) if( cycles_arr->data[ i ] == 0 ) ERR( "Sweep: cycles must be positive." );
+    for( uz_t i = 0; i < weight_scales; i++ ) if( !( weight_scale_arr[ i ] > 0 ) ) ERR( "Sweep: weight scales must be positive." );
+
+    f3_t time_start = guard_time_ms();
+    solver_s* base = solver_s_create();
+    solver_s_setup( base, assigner, src, period );
+
+    const solver_s** solvers = bcore_malloc( sizeof( solver_s* ) * weight_scales );
+    for( uz_t k = 0; k < weight_scales; k++ )
+    {
+        solver_s* solver = solver_s_clone( base );
+        f3_t scale = weight_scale_arr[ k ];
+        for( uz_t i = 0; i < solver->model.persons.size; i++ ) solver->model.persons.data[ i ].weight *= scale;
+        solver->weight_sum *= scale;
+        solvers[ k ] = solver;
+    }
+    f3_t time_setup = guard_time_ms() - time_start;
+
+    uz_t size = weight_scales * cycles_arr->size * rseed_arr->size;
+    sweep_point_s* points = bcore_malloc( sizeof( sweep_point_s ) * ( size + 1 ) );
+    uz_t n = 0;
+    for( uz_t k = 0; k < weight_scales; k++ )
+    {
+        for( uz_t c = 0; c < cycles_arr->size; c++ )
+        {
+            for( uz_t r = 0; r < rseed_arr->size; r++ )
+            {
+                sweep_point_s* point = &points[ n++ ];
+                memset( point, 0, sizeof( *point ) );
+                point->weight_scale_index = k;
+                point->weight_scale = weight_scale_arr[ k ];
+                point->cycles = cycles_arr->data[ c ];
+                point->rseed  = rseed_arr->data[ r ];
+            }
+        }
+    }
+
+    sweep_task_s task = { .solvers = solvers, .points = points };
+    time_start = guard_time_ms();
+    guard_parallel_for( size, sweep_task, &task );
+    f3_t time_total = guard_time_ms() - time_start;
+
+    st_s* log = st_s_create();
+    st_s_pushf( log, "%zu grid points on %zu threads (setup %.3f ms, total %.3f ms)\n\n", size, guard_threads(), time_setup, time_total );
+    st_s_pushf( log, "weight  cycles       rseed         score  unfilled   time[ms]\n" );
+    for( uz_t i = 0; i < size; i++ )
+    {
+        const sweep_point_s* p = &points[ i ];
+        st_s_pushf( log, "%6.2f  %6zu  %10u  %12.6f  %8zu  %9.3f\n", p->weight_scale, p->cycles, ( unsigned )p->rseed, p->score, p->fail_count, p->time );
+    }
+
+    // points of one weight scale and cycles value are consecutive
+    st_s_pushf( log, "\nSummary over %zu rseed values:\n", rseed_arr->size );
+    st_s_pushf( log, "weight  cycles     min score    mean score     max score  mean unfilled  mean time[ms]\n" );
+    for( uz_t i = 0; i < size; i += rseed_arr->size )
+    {
+        f3_t min = points[ i ].score, max = min, sum = 0, unfilled = 0, time = 0;
+        for( uz_t r = 0; r < rseed_arr->size; r++ )
+        {
+            const sweep_point_s* p = &points[ i + r ];
+            min = ( p->score < min ) ? p->score : min;
+            max = ( p->score > max ) ? p->score : max;
+            sum += p->score;
+            unfilled += p->fail_count;
+            time += p->time;
+        }
+        f3_t n = rseed_arr->size;
+        st_s_pushf( log, "%6.2f  %6zu  %12.6f  %12.6f  %12.6f  %13.2f  %13.3f\n", points[ i ].weight_scale, points[ i ].cycles, min, sum / n, max, unfilled / n, time / n );
+    }
+
+    bcore_free( points );
+    for( uz_t k = 0; k < weight_scales; k++ ) solver_s_discard( ( solver_s* )solvers[ k ] );
+    bcore_free( solvers );
+    solver_s_discard( base );
+    return log;
+}
+
+/**********************************************************************************************************************/
+
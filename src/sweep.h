@@ -0,0 +1,54 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Parameter Sweep
+ *  Solves the grid cycles x rseeds x weight scales (all person weights multiplied by the scale).
+ *  Model and calendar are built once (per weight scale); grid points run concurrently.
+ *  Returns a table of score, unfilled days and runtime per point followed by a summary over rseeds
+ *  for each combination of weight scale and cycles.
+ */
+
+/// grid point
+typedef struct sweep_point_s
+{
+    uz_t cycles;
+    u2_t rseed;
+    f3_t weight_scale;
+    uz_t weight_scale_index;
+    f3_t score;
+    uz_t fail_count;
+    f3_t time; // ms
+} sweep_point_s;
+
+st_s* guard_sweep
+(
+    const assigner_s* assigner,
+    const assignment_s* src,
+    period_s period,
+    const bcore_arr_uz_s* cycles_arr,
+    const bcore_arr_uz_s* rseed_arr,
+    const f3_t* weight_scale_arr,
+    uz_t weight_scales
+);
+
+/**********************************************************************************************************************/
+
+#endif // SWEEP_H
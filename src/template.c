@@ -0,0 +1,420 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <pthread.h>
+
+#include "template.h"
+#include "guard.h"
+
+/**********************************************************************************************************************/
+
+static sc_t template_fragment_names[ TEMPLATE_FRAGMENTS ] =
+{
+    "html_begin",
+    "html_head_mo", "html_head_tu", "html_head_we", "html_head_th", "html_head_fr", "html_head_sa", "html_head_su",
+    "html_head_end",
+    "html_week_odd", "html_week_even",
+    "html_cell_outside", "html_cell_regular", "html_cell_vacation", "html_cell_holiday", "html_cell_missing",
+    "html_person", "html_missing", "html_vacation", "html_holiday",
+    "html_cell_end",
+    "html_month", "html_month_year_change", "html_month_pair",
+    "html_end",
+    "month_1", "month_2", "month_3", "month_4", "month_5", "month_6",
+    "month_7", "month_8", "month_9", "month_10", "month_11", "month_12",
+    "calendar_begin", "calendar_end", "calendar_week", "calendar_weekdays", "calendar_marks",
+};
+
+static sc_t template_slot_names[ TEMPLATE_SLOTS ] =
+{
+    "first", "last", "week", "day", "year", "year_prev", "missing", "month1", "month2", "name"
+};
+
+/// built-in layout (html_table in German, calendar in English)
+static sc_t template_default_text =
+"@@ html_begin\n"
+"<!doctype html>\n"
+"<html lang=\"de\">\n"
+"<head>\n"
+"<meta charset=\"utf-8\">\n"
+"<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
+"<title>Crossing Guard Table</title>\n"
+"<style>\n"
+"table {{ border-collapse: separate; border-spacing: 0.2em; background-color: #c0c0c0; }"
+"td {{  text-align: center; background-color: #ffffff; padding: 0.2em; }"
+"th {{  text-align: center; background-color: #f0f0f0; padding: 0.5em; }"
+"</style>\n"
+"</head>\n"
+"<body>\n"
+"<h2>{first} - {last}</h2>\n"
+"<table>\n"
+"<thead>\n"
+"<tr><th> Woche </th>\n"
+"@@ html_head_mo\n<th> Montag </th>\n"
+"@@ html_head_tu\n<th> Dienstag </th>\n"
+"@@ html_head_we\n<th> Mittwoch </th>\n"
+"@@ html_head_th\n<th> Donnerstag </th>\n"
+"@@ html_head_fr\n<th> Freitag </th>\n"
+"@@ html_head_sa\n<th> Samstag </th>\n"
+"@@ html_head_su\n<th> Sonntag </th>\n"
+"@@ html_head_end\n"
+"<th></th></tr>\n"
+"</thead>\n"
+"<tbody>\n"
+"\n"
+"@@ html_week_odd\n<tr style=\"background-color: #ffffff;\"><td style=\"background-color: #f0f0f0;\">{week}</td>\n"
+"@@ html_week_even\n<tr style=\"background-color: #f8f8f8;\"><td style=\"background-color: #f0f0f0;\">{week}</td>\n"
+"@@ html_cell_outside\n<td style=\"background-color: #f0f080;\">{day}\n"
+"@@ html_cell_regular\n<td>{day}\n"
+"@@ html_cell_vacation\n<td style=\"background-color: #f0f0ff;\">{day}\n"
+"@@ html_cell_holiday\n<td style=\"background-color: #f0f0ff;\">{day}\n"
+"@@ html_cell_missing\n<td style=\"background-color: #f08080;\">{day}\n"
+"@@ html_person\n<div><b>{name}</b></div>\n"
+"@@ html_missing\n<div style=\"color: #00ffff; background-color: #ff0000;\"><b>Fehlt</b></div>\n"
+"@@ html_vacation\n<div>Ferien</div>\n"
+"@@ html_holiday\n<div>Schulfrei</div>\n"
+"@@ html_cell_end\n</td>\n"
+"@@ html_month\n<td style=\"background-color: #f0f0f0;\"><div>{month1}</div><div>{year}</div></td>\n"
+"@@ html_month_year_change\n<td style=\"background-color: #f0f0f0;\"><div>{month1} {year_prev}/</div><div>{month2} {year}</div></td>\n"
+"@@ html_month_pair\n<td style=\"background-color: #f0f0f0;\"><div>{month1}/{month2}</div><div>{year}</div></td>\n"
+"@@ html_end\n"
+"</tbody>\n"
+"</table>\n"
+"<body>\n"
+"</body>\n"
+"</html>\n"
+"\n"
+"@@ month_1\nJan\n"
+"@@ month_2\nFeb\n"
+"@@ month_3\nM&auml;r\n"
+"@@ month_4\nApr\n"
+"@@ month_5\nMai\n"
+"@@ month_6\nJun\n"
+"@@ month_7\nJul\n"
+"@@ month_8\nAug\n"
+"@@ month_9\nSep\n"
+"@@ month_10\nOkt\n"
+"@@ month_11\nNov\n"
+"@@ month_12\nDez\n"
+"@@ calendar_begin\n"
+"Period: {first} - {last}\n"
+"\n"
+"@@ calendar_end\n"
+"{missing} missing assignments\n"
+"\n"
+"@@ calendar_week\nW{week}\n"
+"@@ calendar_weekdays\nMTWTFSS\n"
+"@@ calendar_marks\n-#! |\n";
+
+/**********************************************************************************************************************/
+
+static sc_t template_s_def = "template_s = "
+"{"
+    "aware_t _;               "
+    "st_s bytes;              "
+    "bcore_arr_uz_s op_arr;   "
+    "bcore_arr_uz_s first_arr;"
+    "bcore_arr_uz_s end_arr;  "
+"}";
+
+BCORE_DEFINE_FUNCTIONS_SELF_OBJECT_INST( template_s, template_s_def )
+
+static uz_t template_find( sc_t* names, uz_t size, sc_t name, uz_t name_size )
+{
+    for( uz_t i = 0; i < size; i++ )
+    {
+        if( bcore_strlen( names[ i ] ) == name_size && memcmp( names[ i ], name, name_size ) == 0 ) return i;
+    }
+    return size;
+}
+
+static void template_s_push_op( template_s* o, uz_t slot, uz_t offset, uz_t size )
+{
+    bcore_arr_uz_s_push( &o->op_arr, slot );
+    bcore_arr_uz_s_push( &o->op_arr, offset );
+    bcore_arr_uz_s_push( &o->op_arr, size );
+}
+
+/// compiles text[ 0 .. size - 1 ] into fragment; line: first line of text
+static void template_s_compile_fragment( template_s* o, sc_t name, uz_t line, uz_t fragment, sc_t text, uz_t size )
+{
+    o->first_arr.data[ fragment ] = o->op_arr.size;
+    uz_t literal = o->bytes.size;
+    for( uz_t i = 0; i < size; i++ )
+    {
+        char c = text[ i ];
+        if( c == '\n' ) line++;
+        if( c != '{' )
+        {
+            st_s_push_char( &o->bytes, c );
+            continue;
+        }
+        if( i + 1 < size && text[ i + 1 ] == '{' )
+        {
+            st_s_push_char( &o->bytes, '{' );
+            i++;
+            continue;
+        }
+
+        uz_t end = i + 1;
+        while( end < size && text[ end ] != '}' && text[ end ] != '\n' ) end++;
+        if( end == size || text[ end ] != '}' ) ERR( "%s:%zu: Unterminated slot in fragment '%s'.", name, line, template_fragment_names[ fragment ] );
+        uz_t slot = template_find( template_slot_names, TEMPLATE_SLOTS, text + i + 1, end - i - 1 );
+        if( slot == TEMPLATE_SLOTS )
+        {
+            st_s* slot_name = st_s_create();
+            st_s_push_sc_n( slot_name, text + i + 1, end - i - 1 );
+            ERR( "%s:%zu: Unknown slot '%s'. Valid are first, last, week, day, year, year_prev, missing, month1, month2, name.", name, line, slot_name->sc );
+        }
+
+        if( o->bytes.size > literal ) template_s_push_op( o, TEMPLATE_SLOTS, literal, o->bytes.size - literal );
+        template_s_push_op( o, slot, 0, 0 );
+        literal = o->bytes.size;
+        i = end;
+    }
+    if( o->bytes.size > literal ) template_s_push_op( o, TEMPLATE_SLOTS, literal, o->bytes.size - literal );
+    o->end_arr.data[ fragment ] = o->op_arr.size;
+
+    uz_t ops  = ( o->end_arr.data[ fragment ] - o->first_arr.data[ fragment ] ) / 3;
+    uz_t bytes = ( ops > 0 ) ? o->op_arr.data[ o->first_arr.data[ fragment ] + 2 ] : 0;
+    bl_t literal_only = ( ops == 0 ) || ( ops == 1 && o->op_arr.data[ o->first_arr.data[ fragment ] ] == TEMPLATE_SLOTS );
+    sc_t fragment_name = template_fragment_names[ fragment ];
+
+    if( fragment >= TEMPLATE_MONTH_1 && fragment <= TEMPLATE_MONTH_12 && !literal_only )
+    {
+        ERR( "%s: Fragment '%s' must not contain slots.", name, fragment_name );
+    }
+    if( fragment == TEMPLATE_CALENDAR_WEEKDAYS && ( !literal_only || bytes != 7 ) )
+    {
+        ERR( "%s: Fragment '%s' must consist of 7 characters (mo ... su).", name, fragment_name );
+    }
+    if( fragment == TEMPLATE_CALENDAR_MARKS && ( !literal_only || bytes != 5 ) )
+    {
+        ERR( "%s: Fragment '%s' must consist of 5 characters (open, missing, assigned, free, separator).", name, fragment_name );
+    }
+}
+
+void template_s_compile( template_s* o, sc_t name, sc_t text )
+{
+    if( o->first_arr.size < TEMPLATE_FRAGMENTS )
+    {
+        bcore_arr_uz_s_fill( &o->first_arr, TEMPLATE_FRAGMENTS, 0 );
+        bcore_arr_uz_s_fill( &o->end_arr,   TEMPLATE_FRAGMENTS, 0 );
+    }
+
+    uz_t size = bcore_strlen( text );
+    uz_t line = 1;
+    uz_t fragment = TEMPLATE_FRAGMENTS; // text before the first header is ignored
+    uz_t content = 0;
+    uz_t content_line = 0;
+
+    for( uz_t pos = 0; pos <= size; )
+    {
+        uz_t eol = pos;
+        while( eol < size && text[ eol ] != '\n' ) eol++;
+        bl_t header = ( eol - pos >= 2 && text[ pos ] == '@' && text[ pos + 1 ] == '@' );
+
+        if( header || pos == size )
+        {
+            if( fragment < TEMPLATE_FRAGMENTS )
+            {
+                uz_t content_end = ( pos > content && text[ pos - 1 ] == '\n' ) ? pos - 1 : pos; // excludes the preceding line feed
+                template_s_compile_fragment( o, name, content_line, fragment, text + content, content_end - content );
+            }
+            if( pos == size ) break;
+
+            uz_t begin = pos + 2;
+            uz_t end = eol;
+            while( begin < end && ( text[ begin ] == ' ' || text[ begin ] == '\t' ) ) begin++;
+            while( end > begin && ( text[ end - 1 ] == ' ' || text[ end - 1 ] == '\t' || text[ end - 1 ] == '\r' ) ) end--;
+            fragment = template_find( template_fragment_names, TEMPLATE_FRAGMENTS, text + begin, end - begin );
+            if( fragment == TEMPLATE_FRAGMENTS )
+            {
+                st_s* fragment_name = st_s_create();
+                st_s_push_sc_n( fragment_name, text + begin, end - begin );
+                ERR( "%s:%zu: Unknown fragment '%s'. See example/template_en.txt for valid fragments.", name, line, fragment_name->sc );
+            }
+            content = ( eol < size ) ? eol + 1 : eol;
+            content_line = line + 1;
+        }
+
+        if( eol == size ) pos = size; else pos = eol + 1;
+        line++;
+    }
+}
+
+template_s* template_s_create_from_file( sc_t file )
+{
+    FILE* f = fopen( file, "rb" );
+    if( !f ) ERR( "Cannot open template file '%s'.", file );
+    st_s* text = st_s_create();
+    char buf[ 4096 ];
+    uz_t n;
+    while( ( n = fread( buf, 1, sizeof( buf ), f ) ) > 0 ) st_s_push_sc_n( text, buf, n );
+    fclose( f );
+
+    template_s* o = template_s_clone( template_default() );
+    template_s_compile( o, file, text->sc );
+    st_s_discard( text );
+    return o;
+}
+
+/**********************************************************************************************************************/
+
+static template_s* template_default_g = NULL;
+static pthread_mutex_t template_default_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+const template_s* template_default( void )
+{
+    pthread_mutex_lock( &template_default_mutex );
+    if( !template_default_g )
+    {
+        template_default_g = template_s_create();
+        template_s_compile( template_default_g, "default template", template_default_text );
+    }
+    pthread_mutex_unlock( &template_default_mutex );
+    return template_default_g;
+}
+
+/**********************************************************************************************************************/
+
+static void template_push_uz( st_s* out, uz_t v )
+{
+    char buf[ 24 ];
+    uz_t i = sizeof( buf );
+    do { buf[ --i ] = '0' + v % 10; v /= 10; } while( v > 0 );
+    st_s_push_sc_n( out, buf + i, sizeof( buf ) - i );
+}
+
+void template_s_render( const template_s* o, uz_t fragment, const template_values_s* values, st_s* out )
+{
+    const uz_t* op = o->op_arr.data;
+    for( uz_t i = o->first_arr.data[ fragment ]; i < o->end_arr.data[ fragment ]; i += 3 )
+    {
+        uz_t slot = op[ i ];
+        if( slot == TEMPLATE_SLOTS )
+        {
+            st_s_push_sc_n( out, o->bytes.sc + op[ i + 1 ], op[ i + 2 ] );
+            continue;
+        }
+
+        uz_t v = values ? values->value[ slot ] : 0;
+        switch( slot )
+        {
+            case TEMPLATE_SLOT_FIRST:
+            case TEMPLATE_SLOT_LAST:
+            {
+                char buf[ DMY_SIZE ];
+                st_s_push_sc( out, dmy_sc_from_cday( buf, v ) );
+            }
+            break;
+
+            case TEMPLATE_SLOT_MONTH1:
+            case TEMPLATE_SLOT_MONTH2:
+            {
+                if( v >= 1 && v <= 12 ) template_s_render( o, TEMPLATE_MONTH_1 + v - 1, NULL, out );
+            }
+            break;
+
+            case TEMPLATE_SLOT_NAME:
+            {
+                if( values && values->name ) st_s_push_sc( out, values->name );
+            }
+            break;
+
+            default: template_push_uz( out, v ); break;
+        }
+    }
+}
+
+char template_s_char( const template_s* o, uz_t fragment, uz_t index )
+{
+    return o->bytes.data[ o->op_arr.data[ o->first_arr.data[ fragment ] + 1 ] + index ];
+}
+
+/**********************************************************************************************************************/
+
+static void template_selftest( void )
+{
+    const template_s* def = template_default();
+    st_s* out = st_s_create();
+
+    template_values_s values = { { 0 } };
+    values.value[ TEMPLATE_SLOT_MISSING ] = 42;
+    template_s_render( def, TEMPLATE_CALENDAR_END, &values, out );
+    ASSERT( st_s_equal_sc( out, "42 missing assignments\n" ) );
+
+    st_s_clear( out );
+    values.value[ TEMPLATE_SLOT_MONTH1 ] = 12;
+    values.value[ TEMPLATE_SLOT_MONTH2 ] = 1;
+    values.value[ TEMPLATE_SLOT_YEAR_PREV ] = 2018;
+    values.value[ TEMPLATE_SLOT_YEAR ] = 2019;
+    template_s_render( def, TEMPLATE_HTML_MONTH_YEAR_CHANGE, &values, out );
+    ASSERT( st_s_equal_sc( out, "<td style=\"background-color: #f0f0f0;\"><div>Dez 2018/</div><div>Jan 2019</div></td>" ) );
+
+    st_s_clear( out );
+    template_s_render( def, TEMPLATE_HTML_BEGIN, &values, out );
+    ASSERT( out->size > 0 && out->sc[ out->size - 1 ] == '>' );
+    ASSERT( template_s_char( def, TEMPLATE_CALENDAR_WEEKDAYS, 6 ) == 'S' );
+    ASSERT( template_s_char( def, TEMPLATE_CALENDAR_MARKS, 4 ) == '|' );
+
+    // overrides; text before the first fragment is ignored; '{{' is a literal '{'
+    template_s* t = template_s_clone( def );
+    template_s_compile( t, "selftest", "comment\n@@ calendar_week\n{{KW {week}}\n\n@@ month_1\nJanuary\n" );
+    st_s_clear( out );
+    values.value[ TEMPLATE_SLOT_WEEK ] = 7;
+    template_s_render( t, TEMPLATE_CALENDAR_WEEK, &values, out );
+    ASSERT( st_s_equal_sc( out, "{KW 7}\n" ) );
+    st_s_clear( out );
+    template_s_render( t, TEMPLATE_MONTH_1, NULL, out );
+    ASSERT( st_s_equal_sc( out, "January" ) );
+    st_s_clear( out );
+    template_s_render( t, TEMPLATE_MONTH_1 + 1, NULL, out );
+    ASSERT( st_s_equal_sc( out, "Feb" ) );
+
+    template_s_discard( t );
+    st_s_discard( out );
+}
+
+/**********************************************************************************************************************/
+
+vd_t template_signal_handler( const bcore_signal_s* o )
+{
+    switch( bcore_signal_s_handle_type( o, typeof( "template" ) ) )
+    {
+        case TYPEOF_init1:
+        {
+            BCORE_REGISTER_OBJECT( template_s );
+        }
+        break;
+
+        case TYPEOF_down1:
+        {
+            if( template_default_g ) template_s_discard( template_default_g );
+            template_default_g = NULL;
+        }
+        break;
+
+        case TYPEOF_selftest:
+        {
+            template_selftest();
+        }
+        break;
+
+        default: break;
+    }
+    return NULL;
+}
+
+/**********************************************************************************************************************/
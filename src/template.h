@@ -0,0 +1,125 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef TEMPLATE_H
+#define TEMPLATE_H
+
+#include "bcore_std.h"
+
+/**********************************************************************************************************************/
+/** Output Templates (html_table, calendar)
+ *  A template defines the text fragments of a layout. It is compiled once into literal byte ranges and typed slots;
+ *  rendering a fragment copies the literals and formats the slots directly (no format strings).
+ *
+ *  Template file: Each fragment starts with a line '@@ <fragment>'; its text follows up to the line feed preceding
+ *  the next '@@' line (or the end of the file). Text before the first fragment is ignored. In fragment text '{slot}'
+ *  inserts a value; '{{' is a literal '{'. Fragments not defined in a file keep the built-in default.
+ *  See example/template_en.txt for all fragments and slots.
+ */
+
+/// fragments
+enum
+{
+    TEMPLATE_HTML_BEGIN = 0,        // page up to the first header cell; slots: first, last
+    TEMPLATE_HTML_HEAD_MO,          // header cell per active weekday
+    TEMPLATE_HTML_HEAD_TU,
+    TEMPLATE_HTML_HEAD_WE,
+    TEMPLATE_HTML_HEAD_TH,
+    TEMPLATE_HTML_HEAD_FR,
+    TEMPLATE_HTML_HEAD_SA,
+    TEMPLATE_HTML_HEAD_SU,
+    TEMPLATE_HTML_HEAD_END,
+    TEMPLATE_HTML_WEEK_ODD,         // row start and week cell; slot: week
+    TEMPLATE_HTML_WEEK_EVEN,
+    TEMPLATE_HTML_CELL_OUTSIDE,     // day cell start by status; slot: day
+    TEMPLATE_HTML_CELL_REGULAR,
+    TEMPLATE_HTML_CELL_VACATION,
+    TEMPLATE_HTML_CELL_HOLIDAY,
+    TEMPLATE_HTML_CELL_MISSING,
+    TEMPLATE_HTML_PERSON,           // slot: name
+    TEMPLATE_HTML_MISSING,          // label of a missing person
+    TEMPLATE_HTML_VACATION,
+    TEMPLATE_HTML_HOLIDAY,
+    TEMPLATE_HTML_CELL_END,
+    TEMPLATE_HTML_MONTH,            // month cell; slots: month1, year
+    TEMPLATE_HTML_MONTH_YEAR_CHANGE, // slots: month1, year_prev, month2, year
+    TEMPLATE_HTML_MONTH_PAIR,       // slots: month1, month2, year
+    TEMPLATE_HTML_END,
+    TEMPLATE_MONTH_1,               // month names (literal)
+    TEMPLATE_MONTH_12 = TEMPLATE_MONTH_1 + 11,
+    TEMPLATE_CALENDAR_BEGIN,        // slots: first, last
+    TEMPLATE_CALENDAR_END,          // slot: missing
+    TEMPLATE_CALENDAR_WEEK,         // week label; slot: week
+    TEMPLATE_CALENDAR_WEEKDAYS,     // 7 characters mo ... su
+    TEMPLATE_CALENDAR_MARKS,        // 5 characters: open, missing, assigned, free, week separator
+    TEMPLATE_FRAGMENTS
+};
+
+/// slots
+enum
+{
+    TEMPLATE_SLOT_FIRST = 0, // date (cday)
+    TEMPLATE_SLOT_LAST,      // date (cday)
+    TEMPLATE_SLOT_WEEK,
+    TEMPLATE_SLOT_DAY,
+    TEMPLATE_SLOT_YEAR,
+    TEMPLATE_SLOT_YEAR_PREV,
+    TEMPLATE_SLOT_MISSING,
+    TEMPLATE_SLOT_MONTH1,    // month number (rendered as fragment TEMPLATE_MONTH_*)
+    TEMPLATE_SLOT_MONTH2,
+    TEMPLATE_SLOT_NAME,      // text (template_values_s.name)
+    TEMPLATE_SLOTS
+};
+
+/// slot values of a fragment (plain struct)
+typedef struct template_values_s
+{
+    uz_t value[ TEMPLATE_SLOTS ];
+    sc_t name;
+} template_values_s;
+
+#define TYPEOF_template_s typeof( "template_s" )
+typedef struct template_s
+{
+    aware_t _;
+    st_s bytes;               // literals of all fragments
+    bcore_arr_uz_s op_arr;    // triples: slot (TEMPLATE_SLOTS: literal), offset, size
+    bcore_arr_uz_s first_arr; // first op per fragment
+    bcore_arr_uz_s end_arr;   // end of ops per fragment
+} template_s;
+BCORE_DECLARE_FUNCTIONS_OBJ( template_s )
+
+/// compiles the fragments defined in text (name is used in error messages)
+void template_s_compile( template_s* o, sc_t name, sc_t text );
+
+/// built-in default overridden by the fragments of file
+template_s* template_s_create_from_file( sc_t file );
+
+/// built-in default (compiled once)
+const template_s* template_default( void );
+
+/// appends fragment; values: NULL for fragments without slots
+void template_s_render( const template_s* o, uz_t fragment, const template_values_s* values, st_s* out );
+
+/// character index of a literal fragment
+char template_s_char( const template_s* o, uz_t fragment, uz_t index );
+
+/**********************************************************************************************************************/
+
+vd_t template_signal_handler( const bcore_signal_s* o );
+
+/**********************************************************************************************************************/
+
+#endif // TEMPLATE_H
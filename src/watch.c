@@ -0,0 +1,296 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <errno.h>
+#include <fnmatch.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "watch.h"
+#include "context.h"
+#include "loader.h"
+#include "parser.h"
+
+/**********************************************************************************************************************/
+
+/// watched files: directory and file name (or glob pattern)
+typedef struct watch_target_s
+{
+    int wd;
+    st_s* dir;
+    st_s* name;     // file name; NULL: all files of dir not starting with '.'
+    bl_t  pattern;  // name is a glob pattern
+    st_s* excluded; // name of the output file if it lies in dir (NULL: none)
+} watch_target_s;
+
+/// directory and file name of path
+static void path_split( sc_t path, st_s** dir, st_s** name )
+{
+    sc_t slash = strrchr( path, '/' );
+    *dir  = !slash ? st_s_create_sc( "." ) : ( slash == path ) ? st_s_create_sc( "/" ) : st_s_createf( "%.*s", ( int )( slash - path ), path );
+    *name = st_s_create_sc( slash ? slash + 1 : path );
+}
+
+/// true if both directories exist and are the same
+static bl_t same_dir( sc_t dir1, sc_t dir2 )
+{
+    struct stat st1, st2;
+    return stat( dir1, &st1 ) == 0 && stat( dir2, &st2 ) == 0 && st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino;
+}
+
+static void watch_target_init( watch_target_s* o, int fd, sc_t path, sc_t output_file )
+{
+    struct stat st;
+    if( stat( path, &st ) == 0 && S_ISDIR( st.st_mode ) )
+    {
+        o->dir     = st_s_create_sc( path );
+        o->name    = NULL;
+        o->pattern = false;
+    }
+    else
+    {
+        path_split( path, &o->dir, &o->name );
+        o->pattern = !( stat( path, &st ) == 0 && S_ISREG( st.st_mode ) );
+    }
+
+    // writing the output into a watched directory must not trigger another solve
+    o->excluded = NULL;
+    if( output_file )
+    {
+        st_s* output_dir;
+        st_s* output_name;
+        path_split( output_file, &output_dir, &output_name );
+        if( same_dir( o->dir->sc, output_dir->sc ) )
+        {
+            o->excluded = output_name;
+            output_name = NULL;
+        }
+        st_s_discard( output_dir );
+        if( output_name ) st_s_discard( output_name );
+    }
+
+    // directories are watched since editors often save by replacing the file
+    o->wd = inotify_add_watch( fd, o->dir->sc, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE );
+    if( o->wd < 0 ) ERR( "Cannot watch '%s'.", o->dir->sc );
+}
+
+static void watch_target_down( watch_target_s* o )
+{
+    st_s_discard( o->dir );
+    if( o->name     ) st_s_discard( o->name );
+    if( o->excluded ) st_s_discard( o->excluded );
+}
+
+static bl_t watch_target_matches( const watch_target_s* o, const struct inotify_event* event )
+{
+    if( event->wd != o->wd || event->len == 0 ) return false;
+    if( o->excluded && bcore_strcmp( o->excluded->sc, event->name ) == 0 ) return false;
+    if( !o->name ) return event->name[ 0 ] != '.';
+    if( o->pattern ) return fnmatch( o->name->sc, event->name, 0 ) == 0;
+    return bcore_strcmp( o->name->sc, event->name ) == 0;
+}
+
+/**********************************************************************************************************************/
+
+typedef struct watch_s
+{
+    guard_context_s* context;
+    period_s period;
+    sc_t format;
+    sc_t output_file;
+    bl_t cancel;  // set by the watching thread (atomic)
+    bl_t running; // solver thread was started
+    pthread_t thread;
+} watch_s;
+
+static vd_t watch_solve( vd_t arg )
+{
+    watch_s* o = arg;
+    guard_context_s* context = o->context;
+    const assigner_s* assigner = &context->assigner;
+
+    assignment_s* result = NULL;
+    if( assigner->cycles == 0 )
+    {
+        result = assignment_s_clone( &context->assignment );
+    }
+    else
+    {
+        trial_s* best = trial_s_create();
+        solve_control_s control = { .cancel = &o->cancel };
+        solve_stats_s stats;
+        if( assigner_s_branch_search( assigner ) )
+        {
+            solver_s_solve_branch( &context->solver, assigner->rseed, assigner->cycles, best, &control, &stats );
+        }
+        else
+        {
+            solver_s_solve_range( &context->solver, assigner->rseed, 0, assigner->cycles, best, &control, &stats );
+        }
+        if( !stats.cancelled )
+        {
+            result = solver_s_create_assignment( &context->solver, &context->assignment, best );
+        }
+        trial_s_discard( best );
+    }
+
+    if( !result ) return NULL; // cancelled
+
+    st_s* out = guard_context_s_render( context, result, o->period, o->format );
+    if( !out ) ERR( "Unknown output format '%s'.", o->format );
+    if( o->output_file )
+    {
+        bcore_sink* file = bcore_sink_open_file( o->output_file );
+        bcore_sink_a_push_string( file, out );
+        bcore_sink_a_discard( file );
+        bcore_msg( "Updated '%s'.\n", o->output_file );
+    }
+    else
+    {
+        fwrite( out->data, 1, out->size, stdout );
+        fflush( stdout );
+    }
+
+    st_s_discard( out );
+    assignment_s_discard( result );
+    return NULL;
+}
+
+static void watch_s_start( watch_s* o )
+{
+    guard_context_s_prepare( o->context, o->period );
+    __atomic_store_n( &o->cancel, false, __ATOMIC_RELAXED );
+    if( pthread_create( &o->thread, NULL, watch_solve, o ) ) ERR( "Creating thread failed." );
+    o->running = true;
+}
+
+/// cancels a running solve and waits for the solver thread
+static void watch_s_stop( watch_s* o )
+{
+    if( !o->running ) return;
+    __atomic_store_n( &o->cancel, true, __ATOMIC_RELAXED );
+    pthread_join( o->thread, NULL );
+    o->running = false;
+}
+
+/**********************************************************************************************************************/
+
+void guard_watch( sc_t config_file, sc_t assignment_path, period_s period, sc_t format, sc_t output_file )
+{
+    watch_s o = { .period = period, .format = format, .output_file = output_file };
+    o.context = guard_context_s_create_from_files( config_file, assignment_path );
+
+    // the solver thread cannot report an unknown format gracefully
+    {
+        assignment_s* empty = assignment_s_create();
+        st_s* out = guard_context_s_render( o.context, empty, period, format );
+        if( !out ) ERR( "Unknown output format '%s'.", format );
+        st_s_discard( out );
+        assignment_s_discard( empty );
+    }
+
+    int fd = inotify_init1( IN_CLOEXEC );
+    if( fd < 0 ) ERR( "inotify is not available." );
+
+    watch_target_s config_target, assignment_target;
+    watch_target_init( &config_target, fd, config_file, output_file );
+    watch_target_init( &assignment_target, fd, assignment_path, output_file );
+
+    bcore_msg( "Watching '%s' and '%s' (Ctrl-C to stop).\n", config_file, assignment_path );
+    watch_s_start( &o );
+
+    bl_t config_changed = false;
+    bl_t assignment_changed = false;
+    char buf[ 4096 ] __attribute__( ( aligned( __alignof__( struct inotify_event ) ) ) );
+
+    for( ;; )
+    {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int ret = poll( &pfd, 1, ( config_changed || assignment_changed ) ? WATCH_DEBOUNCE_MS : -1 );
+        if( ret < 0 )
+        {
+            if( errno == EINTR ) continue;
+            ERR( "Watching failed." );
+        }
+
+        if( ret == 0 ) // no further change within debounce period
+        {
+            watch_s_stop( &o );
+
+            // a file with errors (e.g. saved halfway or briefly missing) keeps its previous content
+            st_s* err = st_s_create();
+            if( config_changed )
+            {
+                sr_s assigner_sr = parser_try_from_file( config_file, err );
+                if( sr_s_type( &assigner_sr ) == TYPEOF_assigner_s )
+                {
+                    guard_context_s_set_assigner( o.context, assigner_sr.o );
+                }
+                else
+                {
+                    if( err->size == 0 ) st_s_pushf( err, "Incorrect file '%s'. <assigner_s> expected.", config_file );
+                    bcore_err_fa( "#sc_t\nKeeping previous '#sc_t'.\n", err->sc, config_file );
+                }
+                sr_down( assigner_sr );
+            }
+            if( assignment_changed )
+            {
+                st_s_clear( err );
+                assignment_s* assignment = assignment_s_try_create_from_path( assignment_path, err );
+                if( assignment )
+                {
+                    guard_context_s_set_assignment( o.context, assignment );
+                    assignment_s_discard( assignment );
+                }
+                else
+                {
+                    bcore_err_fa( "#sc_t\nKeeping previous '#sc_t'.\n", err->sc, assignment_path );
+                }
+            }
+            st_s_discard( err );
+            config_changed = assignment_changed = false;
+            watch_s_start( &o );
+            continue;
+        }
+
+        ssize_t size = read( fd, buf, sizeof( buf ) );
+        if( size <= 0 ) continue;
+        for( char* p = buf; p < buf + size; )
+        {
+            const struct inotify_event* event = ( const struct inotify_event* )p;
+
+            // events were lost: any input may have changed
+            if( event->mask & IN_Q_OVERFLOW ) config_changed = assignment_changed = true;
+            if( watch_target_matches( &config_target,     event ) ) config_changed = true;
+            if( watch_target_matches( &assignment_target, event ) ) assignment_changed = true;
+            p += sizeof( struct inotify_event ) + event->len;
+        }
+
+        // a newer edit supersedes the solve in progress
+        if( config_changed || assignment_changed ) __atomic_store_n( &o.cancel, true, __ATOMIC_RELAXED );
+    }
+
+    // not reached
+    watch_target_down( &config_target );
+    watch_target_down( &assignment_target );
+    close( fd );
+    guard_context_s_discard( o.context );
+}
+
+/**********************************************************************************************************************/
+
@@ -0,0 +1,35 @@
+/** Copyright 2018 Johannes Bernhard Steffens
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef WATCH_H
+#define WATCH_H
+
+#include "guard.h"
+
+/**********************************************************************************************************************/
+/** Watch Mode
+ *  Watches config and assignment files (inotify) and solves again after each change.
+ *  Parsed inputs, model and calendar are kept in a guard_context_s; only the changed input is parsed again.
+ *  Changes are debounced by WATCH_DEBOUNCE_MS. A change cancels a solve in progress.
+ *  The result is rendered in format and written to output_file (NULL: stdout). Runs until interrupted.
+ */
+
+#define WATCH_DEBOUNCE_MS 200
+
+void guard_watch( sc_t config_file, sc_t assignment_path, period_s period, sc_t format, sc_t output_file );
+
+/**********************************************************************************************************************/
+
+#endif // WATCH_H